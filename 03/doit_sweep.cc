@@ -0,0 +1,244 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -o doit_sweep doit_sweep.cc
+// ./doit_sweep 1 < input  # part 1
+// ./doit_sweep 2 < input  # part 2
+
+// Alternative to doit.cc for fabrics where the claims are huge and
+// sparse.  Nothing here is per-cell; everything is a sweep over the
+// claim edges in x with segment trees over the compressed y
+// coordinates, so it's O(k log k) for k claims regardless of how big
+// the rectangles are.
+
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+struct claim {
+  int num;
+  // Half-open extents, [left, right) x [top, bottom)
+  int left, right;
+  int top, bottom;
+};
+
+vector<claim> read() {
+  vector<claim> result;
+  char _;
+  int num, left, top, wdth, hght;
+  while (cin >> _ >> num >> _ >> left >> _ >> top >> _ >> wdth >> _ >> hght)
+    result.push_back({ num, left, left + wdth, top, top + hght });
+  return result;
+}
+
+// Segment tree over the elementary y intervals [ys[i], ys[i+1]).
+// Each node keeps how many claims cover its whole interval (without
+// pushing down), plus the length of its interval that's covered at
+// least once and at least twice when the counts of its ancestors are
+// ignored.
+struct coverage {
+  vector<int> const &ys;
+  vector<int> cover;
+  vector<long> once;
+  vector<long> twice;
+
+  coverage(vector<int> const &ys_);
+
+  // Add delta to the cover count of elementary intervals [lo, hi)
+  void add(int lo, int hi, int delta) { add(1, 0, ys.size() - 1, lo, hi, delta); }
+
+  // Length covered by two or more claims
+  long contested() const { return twice[1]; }
+
+private:
+  void add(int node, int nlo, int nhi, int lo, int hi, int delta);
+  void pull(int node, int nlo, int nhi);
+};
+
+coverage::coverage(vector<int> const &ys_) :
+  ys(ys_), cover(4 * ys_.size(), 0), once(4 * ys_.size(), 0),
+  twice(4 * ys_.size(), 0) {
+}
+
+void coverage::add(int node, int nlo, int nhi, int lo, int hi, int delta) {
+  if (hi <= nlo || nhi <= lo)
+    return;
+  if (lo <= nlo && nhi <= hi)
+    cover[node] += delta;
+  else {
+    int mid = (nlo + nhi) / 2;
+    add(2 * node, nlo, mid, lo, hi, delta);
+    add(2 * node + 1, mid, nhi, lo, hi, delta);
+  }
+  pull(node, nlo, nhi);
+}
+
+void coverage::pull(int node, int nlo, int nhi) {
+  long full = ys[nhi] - ys[nlo];
+  bool leaf = nhi - nlo == 1;
+  long child_once = leaf ? 0 : once[2 * node] + once[2 * node + 1];
+  long child_twice = leaf ? 0 : twice[2 * node] + twice[2 * node + 1];
+  if (cover[node] >= 2) {
+    once[node] = full;
+    twice[node] = full;
+  } else if (cover[node] == 1) {
+    once[node] = full;
+    // Anything covered once further down is covered twice here
+    twice[node] = child_once;
+  } else {
+    once[node] = child_once;
+    twice[node] = child_twice;
+  }
+}
+
+// Lazy segment tree with range add, range max, and range sum over the
+// elementary y intervals.  This is the interval overlap index for
+// part 2: one instance counts the claims currently active in the
+// sweep, the other accumulates "hits" from claims that overlapped
+// something when they were inserted.
+struct overlap_index {
+  int n;
+  vector<long> mx;
+  vector<long> sum;
+  vector<long> lazy;
+
+  overlap_index(int n_) :
+    n(n_), mx(4 * n_, 0), sum(4 * n_, 0), lazy(4 * n_, 0) {}
+
+  void add(int lo, int hi, long delta) { add(1, 0, n, lo, hi, delta); }
+  long max(int lo, int hi) { return query(1, 0, n, lo, hi).first; }
+  long total(int lo, int hi) { return query(1, 0, n, lo, hi).second; }
+
+private:
+  void apply(int node, int nlo, int nhi, long delta);
+  void push(int node, int nlo, int nhi);
+  void add(int node, int nlo, int nhi, int lo, int hi, long delta);
+  pair<long, long> query(int node, int nlo, int nhi, int lo, int hi);
+};
+
+void overlap_index::apply(int node, int nlo, int nhi, long delta) {
+  mx[node] += delta;
+  sum[node] += delta * (nhi - nlo);
+  lazy[node] += delta;
+}
+
+void overlap_index::push(int node, int nlo, int nhi) {
+  if (lazy[node] == 0)
+    return;
+  int mid = (nlo + nhi) / 2;
+  apply(2 * node, nlo, mid, lazy[node]);
+  apply(2 * node + 1, mid, nhi, lazy[node]);
+  lazy[node] = 0;
+}
+
+void overlap_index::add(int node, int nlo, int nhi, int lo, int hi,
+                        long delta) {
+  if (hi <= nlo || nhi <= lo)
+    return;
+  if (lo <= nlo && nhi <= hi) {
+    apply(node, nlo, nhi, delta);
+    return;
+  }
+  push(node, nlo, nhi);
+  int mid = (nlo + nhi) / 2;
+  add(2 * node, nlo, mid, lo, hi, delta);
+  add(2 * node + 1, mid, nhi, lo, hi, delta);
+  mx[node] = std::max(mx[2 * node], mx[2 * node + 1]);
+  sum[node] = sum[2 * node] + sum[2 * node + 1];
+}
+
+pair<long, long> overlap_index::query(int node, int nlo, int nhi, int lo,
+                                      int hi) {
+  if (hi <= nlo || nhi <= lo)
+    return { 0, 0 };
+  if (lo <= nlo && nhi <= hi)
+    return { mx[node], sum[node] };
+  push(node, nlo, nhi);
+  int mid = (nlo + nhi) / 2;
+  auto [mx1, sum1] = query(2 * node, nlo, mid, lo, hi);
+  auto [mx2, sum2] = query(2 * node + 1, mid, nhi, lo, hi);
+  return { std::max(mx1, mx2), sum1 + sum2 };
+}
+
+pair<long, int> solve() {
+  auto claims = read();
+  assert(!claims.empty());
+  vector<int> ys;
+  for (auto const &c : claims) {
+    ys.push_back(c.top);
+    ys.push_back(c.bottom);
+  }
+  sort(ys.begin(), ys.end());
+  ys.erase(unique(ys.begin(), ys.end()), ys.end());
+  auto y_index = [&](int y) {
+    return int(lower_bound(ys.begin(), ys.end(), y) - ys.begin());
+  };
+  // Events are { x, +1 for left edge or -1 for right edge, claim
+  // index }.  Right edges sort first at the same x since the extents
+  // are half-open.
+  vector<tuple<int, int, int>> events;
+  for (size_t i = 0; i < claims.size(); ++i) {
+    events.emplace_back(claims[i].left, +1, i);
+    events.emplace_back(claims[i].right, -1, i);
+  }
+  sort(events.begin(), events.end());
+  int n = ys.size() - 1;
+  coverage area(ys);
+  overlap_index active(n);
+  overlap_index hits(n);
+  // Hits on a claim's y range when it was inserted, and whether it's
+  // known to be contested
+  vector<long> hits_at_insert(claims.size(), 0);
+  vector<bool> contested(claims.size(), false);
+  long contested_area = 0;
+  int last_x = get<0>(events.front());
+  for (auto [x, delta, i] : events) {
+    contested_area += area.contested() * (x - last_x);
+    last_x = x;
+    int lo = y_index(claims[i].top);
+    int hi = y_index(claims[i].bottom);
+    if (lo == hi)
+      // Empty claim
+      continue;
+    if (delta > 0) {
+      if (active.max(lo, hi) > 0) {
+        // Overlaps some claim already active, and every claim active
+        // over this range overlaps it.  Leave a hit so they'll find
+        // out when they're removed.
+        contested[i] = true;
+        hits.add(lo, hi, 1);
+      }
+      hits_at_insert[i] = hits.total(lo, hi);
+      active.add(lo, hi, 1);
+    } else {
+      active.add(lo, hi, -1);
+      if (hits.total(lo, hi) != hits_at_insert[i])
+        contested[i] = true;
+    }
+    area.add(lo, hi, delta);
+  }
+  int uncontested = -1;
+  for (size_t i = 0; i < claims.size(); ++i)
+    if (!contested[i]) {
+      assert(uncontested == -1);
+      uncontested = claims[i].num;
+    }
+  return { contested_area, uncontested };
+}
+
+void part1() { cout << solve().first << '\n'; }
+void part2() { cout << solve().second << '\n'; }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
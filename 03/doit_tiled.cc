@@ -0,0 +1,170 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -pthread -o doit_tiled doit_tiled.cc
+// ./doit_tiled 1 < input  # part 1
+// ./doit_tiled 2 < input  # part 2
+
+// Alternative to doit.cc for large dense fabrics.  The fabric is cut
+// into tiles small enough that a tile's counts stay in cache, each
+// claim is binned to the tiles it touches, and the tiles are then
+// counted independently by a pool of threads.  Threads grab the next
+// unclaimed tile until there are none left, so a thread that finishes
+// a cheap tile just moves on to another one.  Each thread keeps its
+// own contested total and per-claim flags, and those get merged at
+// the end.
+
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <cassert>
+
+using namespace std;
+
+// Tiles are tile_size x tile_size cells; 64 x 64 ints is 16KB
+int const tile_size = 64;
+
+struct claim {
+  int num;
+  int left, top;
+  int wdth, hght;
+};
+
+struct fabric {
+  vector<claim> claims;
+  // Bounding box of all claims, in units of tiles
+  int tile_x0, tile_y0;
+  int tiles_w, tiles_h;
+  // claims_in[t] is the indexes of claims touching tile t
+  vector<vector<int>> claims_in;
+
+  // Construct from stdin, bin claims to tiles
+  fabric();
+
+  // Count one tile.  Adds the number of contested cells to contested
+  // and sets touched[i] for claims that have a contested cell in the
+  // tile.
+  void count_tile(int t, vector<int> &counts, long &contested,
+                  vector<bool> &touched) const;
+
+  pair<long, int> solve() const;
+};
+
+// Floor division, since claims could in principle be at negative
+// coordinates
+int tile_of(int x) { return x >= 0 ? x / tile_size : -((-x - 1) / tile_size) - 1; }
+
+fabric::fabric() {
+  char _;
+  int num, left, top, wdth, hght;
+  while (cin >> _ >> num >> _ >> left >> _ >> top >> _ >> wdth >> _ >> hght)
+    claims.push_back({ num, left, top, wdth, hght });
+  assert(!claims.empty());
+  int tile_x1 = tile_x0 = tile_of(claims.front().left);
+  int tile_y1 = tile_y0 = tile_of(claims.front().top);
+  for (auto const &c : claims) {
+    tile_x0 = min(tile_x0, tile_of(c.left));
+    tile_y0 = min(tile_y0, tile_of(c.top));
+    tile_x1 = max(tile_x1, tile_of(c.left + c.wdth - 1));
+    tile_y1 = max(tile_y1, tile_of(c.top + c.hght - 1));
+  }
+  tiles_w = tile_x1 - tile_x0 + 1;
+  tiles_h = tile_y1 - tile_y0 + 1;
+  claims_in.resize(tiles_w * tiles_h);
+  for (size_t i = 0; i < claims.size(); ++i) {
+    auto const &c = claims[i];
+    if (c.wdth <= 0 || c.hght <= 0)
+      continue;
+    for (int ty = tile_of(c.top); ty <= tile_of(c.top + c.hght - 1); ++ty)
+      for (int tx = tile_of(c.left); tx <= tile_of(c.left + c.wdth - 1); ++tx)
+        claims_in[(ty - tile_y0) * tiles_w + (tx - tile_x0)].push_back(i);
+  }
+}
+
+void fabric::count_tile(int t, vector<int> &counts, long &contested,
+                        vector<bool> &touched) const {
+  auto const &in_tile = claims_in[t];
+  if (in_tile.size() < 2)
+    // Nothing can be contested
+    return;
+  int x0 = (tile_x0 + t % tiles_w) * tile_size;
+  int y0 = (tile_y0 + t / tiles_w) * tile_size;
+  // Clip a claim to the tile, returning tile-relative [x0, x1) x [y0, y1)
+  auto clip = [&](claim const &c) {
+    return make_tuple(max(c.left, x0) - x0,
+                      min(c.left + c.wdth, x0 + tile_size) - x0,
+                      max(c.top, y0) - y0,
+                      min(c.top + c.hght, y0 + tile_size) - y0);
+  };
+  fill(counts.begin(), counts.end(), 0);
+  for (int i : in_tile) {
+    auto [cx0, cx1, cy0, cy1] = clip(claims[i]);
+    for (int y = cy0; y < cy1; ++y)
+      for (int x = cx0; x < cx1; ++x)
+        if (++counts[y * tile_size + x] == 2)
+          ++contested;
+  }
+  for (int i : in_tile) {
+    if (touched[i])
+      continue;
+    auto [cx0, cx1, cy0, cy1] = clip(claims[i]);
+    for (int y = cy0; y < cy1 && !touched[i]; ++y)
+      for (int x = cx0; x < cx1; ++x)
+        if (counts[y * tile_size + x] >= 2) {
+          touched[i] = true;
+          break;
+        }
+  }
+}
+
+pair<long, int> fabric::solve() const {
+  int num_threads = max(1u, thread::hardware_concurrency());
+  int num_tiles = claims_in.size();
+  num_threads = min(num_threads, num_tiles);
+  atomic<int> next_tile{ 0 };
+  vector<long> contested(num_threads, 0);
+  vector<vector<bool>> touched(num_threads,
+                               vector<bool>(claims.size(), false));
+  auto worker = [&](int id) {
+    vector<int> counts(tile_size * tile_size);
+    for (int t = next_tile++; t < num_tiles; t = next_tile++)
+      count_tile(t, counts, contested[id], touched[id]);
+  };
+  vector<thread> pool;
+  for (int id = 1; id < num_threads; ++id)
+    pool.emplace_back(worker, id);
+  worker(0);
+  for (auto &th : pool)
+    th.join();
+  // Merge
+  long total_contested = 0;
+  for (auto c : contested)
+    total_contested += c;
+  int uncontested = -1;
+  for (size_t i = 0; i < claims.size(); ++i) {
+    bool any_touched = false;
+    for (auto const &t : touched)
+      any_touched = any_touched || t[i];
+    if (!any_touched) {
+      assert(uncontested == -1);
+      uncontested = claims[i].num;
+    }
+  }
+  return { total_contested, uncontested };
+}
+
+void part1() { cout << fabric().solve().first << '\n'; }
+void part2() { cout << fabric().solve().second << '\n'; }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
@@ -6,45 +6,100 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <array>
 #include <map>
+#include <optional>
 #include <algorithm>
+#include <cstdint>
+#include <cctype>
 #include <cassert>
 
 using namespace std;
 
-using sleeping = vector<bool>;
+// Each night is a bitmask of minutes asleep, bit i for 00:i
+using sleeping = uint64_t;
 using nights = vector<sleeping>;
 map<int, nights> guards;
 
+// A timestamp packed so that integer order is time order.  Month,
+// day, hour, and minute each get their own bit field, so no calendar
+// arithmetic is needed.
+uint64_t timestamp(int year, int month, int day, int hour, int minute) {
+  return ((((uint64_t(year) << 4 | month) << 5 | day) << 5 | hour) << 6) |
+    minute;
+}
+
+// Log events.  what is the guard number for the start of a shift, or
+// falls_asleep or wakes_up
+enum { falls_asleep = -1, wakes_up = -2 };
+struct log_entry {
+  uint64_t when;
+  int what;
+};
+
+// LSD radix sort on the timestamps, 8 bits per pass, skipping the
+// high bytes that are all zero
+void radix_sort(vector<log_entry> &log) {
+  uint64_t max_when = 0;
+  for (auto const &entry : log)
+    max_when = max(max_when, entry.when);
+  vector<log_entry> scratch(log.size());
+  for (int shift = 0; shift < 64 && (max_when >> shift) != 0; shift += 8) {
+    array<size_t, 257> start{};
+    for (auto const &entry : log)
+      ++start[((entry.when >> shift) & 0xff) + 1];
+    for (int b = 0; b < 256; ++b)
+      start[b + 1] += start[b];
+    for (auto const &entry : log)
+      scratch[start[(entry.when >> shift) & 0xff]++] = entry;
+    log.swap(scratch);
+  }
+}
+
 void read() {
-  vector<string> log;
+  vector<log_entry> log;
   string line;
-  while (getline(cin, line))
-    log.push_back(line);
-  sort(log.begin(), log.end());
+  // [YYYY-MM-DD hh:mm] event
+  auto number = [&](size_t pos, size_t len) {
+                  int result = 0;
+                  for (size_t i = pos; i < pos + len; ++i) {
+                    assert(isdigit(line[i]));
+                    result = 10 * result + (line[i] - '0');
+                  }
+                  return result;
+                };
+  while (getline(cin, line)) {
+    assert(line.length() > 19 && line[0] == '[' && line[17] == ']');
+    uint64_t when = timestamp(number(1, 4), number(6, 2), number(9, 2),
+                              number(12, 2), number(15, 2));
+    int what;
+    switch (line[19]) {
+    case 'f': what = falls_asleep; break;
+    case 'w': what = wakes_up; break;
+    default: {
+      string gn = "Guard #";
+      auto pos = line.find(gn);
+      assert(pos != string::npos);
+      what = 0;
+      for (pos += gn.size(); pos < line.length() && isdigit(line[pos]); ++pos)
+        what = 10 * what + (line[pos] - '0');
+    }
+    }
+    log.push_back({ when, what });
+  }
+  radix_sort(log);
   for (size_t i = 0; i < log.size(); ) {
-    auto const &entry = log[i++];
-    string gn = "Guard #";
-    auto pos = entry.find(gn);
-    assert(pos != string::npos);
-    int num = stoi(entry.substr(pos + gn.size()));
+    int num = log[i++].what;
+    assert(num >= 0);
     auto &guard = guards[num];
-    sleeping night(60, false);
-    auto event = [](string const &entry) {
-                   auto pos = entry.find(']');
-                   assert(pos != string::npos && pos >= 2);
-                   int time = stoi(entry.substr(pos - 2, 2));
-                   assert(pos + 2 < entry.length());
-                   char event = entry[pos + 2];
-                   return make_pair(time, event);
-                 };
-    while (i < log.size() && log[i].find(gn) == string::npos) {
+    sleeping night = 0;
+    while (i < log.size() && log[i].what < 0) {
       assert(i + 1 < log.size());
-      auto [time1, event1] = event(log[i]);
-      auto [time2, event2] = event(log[i + 1]);
-      assert(event1 == 'f' && event2 == 'w');
+      assert(log[i].what == falls_asleep && log[i + 1].what == wakes_up);
+      int time1 = log[i].when & 0x3f;
+      int time2 = log[i + 1].when & 0x3f;
       assert(0 <= time1 && time1 < time2 && time2 < 60);
-      fill(night.begin() + time1, night.begin() + time2, true);
+      night |= (uint64_t(1) << time2) - (uint64_t(1) << time1);
       i += 2;
     }
     guard.push_back(night);
@@ -55,13 +110,12 @@ void read() {
 // { total sleep, max sleep over all minutes, minute for max sleep }
 array<int, 3> sleepiness(nights const &all_nights) {
   int sleeping = 0;
-  vector<int> per_night(60, 0);
-  for (auto const &night : all_nights)
-    for (int i = 0; i < 60; ++i)
-      if (night[i]) {
-        ++sleeping;
-        ++per_night[i];
-      }
+  array<int, 60> per_night{};
+  for (auto night : all_nights) {
+    sleeping += __builtin_popcountll(night);
+    for (; night != 0; night &= night - 1)
+      ++per_night[__builtin_ctzll(night)];
+  }
   auto p = max_element(per_night.begin(), per_night.end());
   int sleepiest_minute = p - per_night.begin();
   return { sleeping, per_night[sleepiest_minute], sleepiest_minute };
@@ -0,0 +1,181 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -o doit_stream doit_stream.cc
+// ./doit_stream 1 < input  # part 1
+// ./doit_stream 2 < input  # part 2
+
+// Alternative to doit.cc that processes the log as a stream.  Lines
+// go through a bounded reorder buffer keyed by timestamp, and
+// whatever comes out of the buffer (in time order) updates per-guard
+// running statistics.  Nothing about individual nights is kept, and
+// answering a query is just a scan over the guards.
+//
+// The reorder buffer holds reorder_window entries, so the log only
+// has to be sorted to within that many lines.  The example and real
+// inputs are small enough to fit entirely.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cctype>
+#include <cassert>
+
+using namespace std;
+
+size_t const reorder_window = 1 << 16;
+
+// A timestamp packed so that integer order is time order
+uint64_t timestamp(int year, int month, int day, int hour, int minute) {
+  return ((((uint64_t(year) << 4 | month) << 5 | day) << 5 | hour) << 6) |
+    minute;
+}
+
+// Log events.  what is the guard number for the start of a shift, or
+// falls_asleep or wakes_up
+enum { falls_asleep = -1, wakes_up = -2 };
+struct log_entry {
+  uint64_t when;
+  int what;
+
+  bool operator>(log_entry const &other) const { return when > other.when; }
+};
+
+// Parse one line, [YYYY-MM-DD hh:mm] event
+log_entry parse(string const &line) {
+  auto number = [&](size_t pos, size_t len) {
+                  int result = 0;
+                  for (size_t i = pos; i < pos + len; ++i) {
+                    assert(isdigit(line[i]));
+                    result = 10 * result + (line[i] - '0');
+                  }
+                  return result;
+                };
+  assert(line.length() > 19 && line[0] == '[' && line[17] == ']');
+  uint64_t when = timestamp(number(1, 4), number(6, 2), number(9, 2),
+                            number(12, 2), number(15, 2));
+  switch (line[19]) {
+  case 'f': return { when, falls_asleep };
+  case 'w': return { when, wakes_up };
+  default: break;
+  }
+  string gn = "Guard #";
+  auto pos = line.find(gn);
+  assert(pos != string::npos);
+  int num = 0;
+  for (pos += gn.size(); pos < line.length() && isdigit(line[pos]); ++pos)
+    num = 10 * num + (line[pos] - '0');
+  return { when, num };
+}
+
+struct guard_stats {
+  // Total minutes asleep
+  int total{0};
+  // per_minute[i] is the number of nights asleep at 00:i
+  array<int, 60> per_minute{};
+};
+
+struct aggregator {
+  map<int, guard_stats> guards;
+  // Guard currently on shift, if any
+  guard_stats *on_duty{nullptr};
+  // Minute the guard fell asleep, or -1 if awake
+  int asleep_since{-1};
+  // For checking that the stream really is sorted
+  uint64_t last_when{0};
+
+  // Update statistics for the next entry in time order
+  void add(log_entry const &entry);
+
+  // Summarize sleepiness for one guard.  Returns:
+  // { total sleep, max sleep over all minutes, minute for max sleep }
+  static array<int, 3> sleepiness(guard_stats const &stats);
+
+  // Chooses the guard based on sleepiness(...)[best_choice], returns
+  // the guard number times the sleepiest minute
+  int solve(unsigned best_choice) const;
+};
+
+void aggregator::add(log_entry const &entry) {
+  if (entry.when < last_when) {
+    cerr << "log is out of order by more than " << reorder_window
+         << " entries\n";
+    exit(1);
+  }
+  last_when = entry.when;
+  int minute = entry.when & 0x3f;
+  switch (entry.what) {
+  case falls_asleep:
+    assert(on_duty && asleep_since < 0);
+    asleep_since = minute;
+    break;
+  case wakes_up:
+    assert(on_duty && 0 <= asleep_since && asleep_since < minute);
+    assert(minute < 60);
+    on_duty->total += minute - asleep_since;
+    for (int i = asleep_since; i < minute; ++i)
+      ++on_duty->per_minute[i];
+    asleep_since = -1;
+    break;
+  default:
+    assert(asleep_since < 0);
+    on_duty = &guards[entry.what];
+    break;
+  }
+}
+
+array<int, 3> aggregator::sleepiness(guard_stats const &stats) {
+  auto const &per_minute = stats.per_minute;
+  auto p = max_element(per_minute.begin(), per_minute.end());
+  int sleepiest_minute = p - per_minute.begin();
+  return { stats.total, per_minute[sleepiest_minute], sleepiest_minute };
+}
+
+int aggregator::solve(unsigned best_choice) const {
+  int sleepiest = -1;
+  array<int, 3> sleepiest_info{};
+  for (auto const & [num, stats] : guards) {
+    auto info = sleepiness(stats);
+    if (sleepiest == -1 || info[best_choice] >= sleepiest_info[best_choice]) {
+      sleepiest = num;
+      sleepiest_info = info;
+    }
+  }
+  assert(sleepiest != -1);
+  return sleepiest * sleepiest_info[2];
+}
+
+void solve(unsigned best_choice) {
+  aggregator stats;
+  priority_queue<log_entry, vector<log_entry>, greater<log_entry>> pending;
+  string line;
+  while (getline(cin, line)) {
+    pending.push(parse(line));
+    if (pending.size() > reorder_window) {
+      stats.add(pending.top());
+      pending.pop();
+    }
+  }
+  for (; !pending.empty(); pending.pop())
+    stats.add(pending.top());
+  cout << stats.solve(best_choice) << '\n';
+}
+
+void part1() { solve(0); }
+void part2() { solve(1); }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
@@ -4,45 +4,62 @@
 // ./doit 2 < input  # part 2
 
 #include <iostream>
-#include <cctype>
+#include <string>
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
 
-bool react(char u1, char u2) {
-  return u1 != u2 && tolower(u1) == tolower(u2);
-}
+// Units react when they're the same letter with opposite case, which
+// for ASCII letters means they differ in exactly the 0x20 bit
+bool react(char u1, char u2) { return (u1 ^ u2) == 0x20; }
 
-string react(string const &polymer) {
-  string result;
+// React polymer in place, using it as its own stack
+void react(string &polymer) {
+  size_t top = 0;
   for (char u : polymer)
-    if (!result.empty() && react(result.back(), u))
-      result.pop_back();
+    if (top > 0 && react(polymer[top - 1], u))
+      --top;
     else
-      result.push_back(u);
-  return result;
+      polymer[top++] = u;
+  polymer.resize(top);
 }
 
-string strip(string const &polymer, char drop) {
-  string result;
-  for (char u : polymer)
-    if (tolower(u) != drop)
-      result.push_back(u);
-  return result;
+// Length of polymer after dropping all units of type drop (lower
+// case) and reacting.  buffer is scratch space for the stack.
+size_t react_without(string const &polymer, char drop, string &buffer) {
+  buffer.resize(polymer.length());
+  size_t top = 0;
+  for (char u : polymer) {
+    if ((u | 0x20) == drop)
+      continue;
+    if (top > 0 && react(buffer[top - 1], u))
+      --top;
+    else
+      buffer[top++] = u;
+  }
+  return top;
 }
 
 void part1() {
   string polymer;
   cin >> polymer;
-  cout << react(polymer).size() << '\n';
+  react(polymer);
+  cout << polymer.size() << '\n';
 }
 
 void part2() {
   string polymer;
   cin >> polymer;
+  // Removing a unit type commutes with reacting, since any reaction
+  // in the original polymer can still happen after the removal.  So
+  // react everything once up front and then try the removals on the
+  // (much shorter) result.
+  react(polymer);
   size_t min_length = polymer.length();
+  string buffer;
   for (char c = 'a'; c <= 'z'; ++c)
-    min_length = min(min_length, react(strip(polymer, c)).length());
+    min_length = min(min_length, react_without(polymer, c, buffer));
   cout << min_length << '\n';
 }
 
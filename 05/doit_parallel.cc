@@ -0,0 +1,109 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -pthread -o doit_parallel doit_parallel.cc
+// ./doit_parallel 1 < input  # part 1
+// ./doit_parallel 2 < input  # part 2
+
+// Alternative to doit.cc for enormous polymers.  Reaction is
+// reduction in a free group, so it's associative: the polymer can be
+// cut into chunks, each chunk reduced on its own thread, and then the
+// reduced chunks stitched back together left to right, with units
+// cancelling at each seam.  A cancellation at a seam can eat all the
+// way back through earlier chunks, so the stitched result is kept as
+// a stack of (chunk, begin, end) pieces rather than being copied.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <thread>
+#include <algorithm>
+#include <cctype>
+#include <cassert>
+
+using namespace std;
+
+bool react(char u1, char u2) {
+  return u1 != u2 && tolower(u1) == tolower(u2);
+}
+
+string react(string::const_iterator begin, string::const_iterator end) {
+  string result;
+  for (auto p = begin; p != end; ++p)
+    if (!result.empty() && react(result.back(), *p))
+      result.pop_back();
+    else
+      result.push_back(*p);
+  return result;
+}
+
+string parallel_react(string const &polymer) {
+  size_t num_threads = max(1u, thread::hardware_concurrency());
+  size_t chunk_size = (polymer.length() + num_threads - 1) / num_threads;
+  if (chunk_size == 0)
+    return polymer;
+  vector<string> chunks((polymer.length() + chunk_size - 1) / chunk_size);
+  vector<thread> pool;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    auto begin = polymer.begin() + i * chunk_size;
+    auto end = polymer.begin() + min(polymer.length(), (i + 1) * chunk_size);
+    pool.emplace_back([&, i, begin, end] { chunks[i] = react(begin, end); });
+  }
+  for (auto &th : pool)
+    th.join();
+  // Stitch.  Each piece is { chunk index, begin, end } for the units
+  // of a chunk that are still surviving.
+  vector<tuple<size_t, size_t, size_t>> pieces;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    auto const &chunk = chunks[i];
+    size_t start = 0;
+    while (start < chunk.length() && !pieces.empty()) {
+      auto &[j, begin, end] = pieces.back();
+      if (!react(chunks[j][end - 1], chunk[start]))
+        break;
+      ++start;
+      if (--end == begin)
+        pieces.pop_back();
+    }
+    if (start < chunk.length())
+      pieces.emplace_back(i, start, chunk.length());
+  }
+  string result;
+  for (auto [i, begin, end] : pieces)
+    result.append(chunks[i], begin, end - begin);
+  return result;
+}
+
+string strip(string const &polymer, char drop) {
+  string result;
+  for (char u : polymer)
+    if (tolower(u) != drop)
+      result.push_back(u);
+  return result;
+}
+
+void part1() {
+  string polymer;
+  cin >> polymer;
+  cout << parallel_react(polymer).size() << '\n';
+}
+
+void part2() {
+  string polymer;
+  cin >> polymer;
+  size_t min_length = polymer.length();
+  for (char c = 'a'; c <= 'z'; ++c)
+    min_length = min(min_length, parallel_react(strip(polymer, c)).length());
+  cout << min_length << '\n';
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
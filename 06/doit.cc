@@ -1,11 +1,13 @@
 // -*- C++ -*-
-// g++ -std=c++17 -Wall -g -o doit doit.cc
+// g++ -std=c++17 -Wall -g -O3 -pthread -o doit doit.cc
 // ./doit 1 < input  # part 1
 // ./doit 2 < input  # part 2
 
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <atomic>
 #include <cassert>
 
 using namespace std;
@@ -29,25 +31,33 @@ coords max(coords const &c1, coords const &c2) {
   return { max(c1.first, c2.first), max(c1.second, c2.second) };
 }
 
-int manhattan(coords const &c1, coords const &c2) {
-  return abs(c1.first - c2.first) + abs(c1.second - c2.second);
-}
-
 enum status { boundary = -1, closest };
 
+// Cells are processed in blocks of this many along a row; the block
+// loop over lanes is written so the compiler can vectorize it
+int const lanes = 16;
+// Rows per unit of work handed to a thread
+int const tile_rows = 8;
+
 struct grid {
-  // Original points
-  vector<coords> coordinates;
+  // Original points, as separate x and y arrays
+  vector<int> xs;
+  vector<int> ys;
   // Bounding box
   coords ll;
   coords ur;
-  // dist_info[y][x] (with indexes offset by ll) is
-  // { closest point (or boundary), total distance to all points }
-  vector<vector<pair<int, int>>> dist_info;
+  int w, h;
+  // For the cell at (x, y), index (y - ll.y) * w + (x - ll.x), the
+  // closest point (or boundary) and total distance to all points
+  vector<int> closest_point;
+  vector<int> total_dist;
 
-  // Construct from stdin, compute dist_info
+  // Construct from stdin, compute closest_point and total_dist
   grid();
 
+  // Fill in one row from x = ll.x up
+  void compute_row(int y);
+
   pair<int, int> distances(coords const &c) const;
 
   int part1() const;
@@ -57,47 +67,75 @@ struct grid {
 grid::grid() {
   char comma;
   int x, y;
-  while (cin >> x >> comma >> y)
-    coordinates.emplace_back(x, y);
-  assert(!coordinates.empty());
-  ll = coordinates.front();
-  ur = ll;
-  for (auto const &c : coordinates) {
-    ll = min(ll, c);
-    ur = max(ur, c);
+  while (cin >> x >> comma >> y) {
+    xs.push_back(x);
+    ys.push_back(y);
+  }
+  assert(!xs.empty());
+  ll = ur = { xs.front(), ys.front() };
+  for (size_t i = 0; i < xs.size(); ++i) {
+    ll = min(ll, { xs[i], ys[i] });
+    ur = max(ur, { xs[i], ys[i] });
   }
   coords dxy = ur - ll;
-  int w = dxy.first + 1;
-  int h = dxy.second + 1;
-  dist_info.resize(h, vector<pair<int, int>>(w, { 0, 0 }));
-  for (int y = ll.second; y <= ur.second; ++y) {
-    for (int x = ll.first; x <= ur.first; ++x) {
-      coords xy{ x, y };
-      int total_dist = manhattan(xy, coordinates[0]);
-      int status = closest + 0;
-      int min_dist = total_dist;
-      for (size_t i = 1; i < coordinates.size(); ++i) {
-        int disti = manhattan(xy, coordinates[i]);
-        total_dist += disti;
-        if (disti < min_dist) {
-          min_dist = disti;
-          status = closest + i;
-        } else if (disti == min_dist)
-          status = boundary;
+  w = dxy.first + 1;
+  h = dxy.second + 1;
+  closest_point.resize(w * h);
+  total_dist.resize(w * h);
+  int num_threads = max(1u, thread::hardware_concurrency());
+  atomic<int> next_tile{ 0 };
+  auto worker = [&] {
+                  for (int t = next_tile++; t * tile_rows < h; t = next_tile++)
+                    for (int r = t * tile_rows; r < min(h, (t + 1) * tile_rows); ++r)
+                      compute_row(ll.second + r);
+                };
+  vector<thread> pool;
+  for (int i = 1; i < num_threads; ++i)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &th : pool)
+    th.join();
+}
+
+void grid::compute_row(int y) {
+  int n = xs.size();
+  int *row_closest = &closest_point[(y - ll.second) * w];
+  int *row_total = &total_dist[(y - ll.second) * w];
+  for (int x0 = 0; x0 < w; x0 += lanes) {
+    int x[lanes], min_dist[lanes], status[lanes], total[lanes];
+    for (int k = 0; k < lanes; ++k) {
+      x[k] = ll.first + x0 + k;
+      min_dist[k] = abs(x[k] - xs[0]) + abs(y - ys[0]);
+      status[k] = closest + 0;
+      total[k] = min_dist[k];
+    }
+    for (int i = 1; i < n; ++i) {
+      int xi = xs[i];
+      int dy = abs(y - ys[i]);
+      for (int k = 0; k < lanes; ++k) {
+        int disti = abs(x[k] - xi) + dy;
+        total[k] += disti;
+        status[k] = disti < min_dist[k] ? closest + i :
+          disti == min_dist[k] ? boundary : status[k];
+        min_dist[k] = min(min_dist[k], disti);
       }
-      dist_info[y - ll.second][x - ll.first] = { status, total_dist };
+    }
+    for (int k = 0; k < lanes && x0 + k < w; ++k) {
+      row_closest[x0 + k] = status[k];
+      row_total[x0 + k] = total[k];
     }
   }
 }
 
 pair<int, int> grid::distances(coords const &c) const {
   coords c1 = c - ll;
-  return dist_info[c1.second][c1.first];
+  int i = c1.second * w + c1.first;
+  return { closest_point[i], total_dist[i] };
 }
 
 int grid::part1() const {
   // Points whose index is on an edge have unbounded regions
-  vector<int> areas(coordinates.size(), 0);
+  vector<int> areas(xs.size(), 0);
   for (int y = ll.second; y <= ur.second; ++y)
     for (int x = ll.first; x <= ur.first; ++x) {
       int index = distances({ x, y }).first;
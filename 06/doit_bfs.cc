@@ -0,0 +1,191 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -o doit_bfs doit_bfs.cc
+// ./doit_bfs 1 < input  # part 1
+// ./doit_bfs 2 < input  # part 2
+
+// Alternative to doit.cc for many points over large boxes.  Part 1
+// labels each cell with its closest point using a breadth-first
+// search from all the points at once, so it's O(W*H) no matter how
+// many points there are.  BFS distance on the grid is Manhattan
+// distance, and the set of closest points for a cell is the union of
+// the sets for its neighbors one step closer, so ties propagate
+// naturally: a cell is a tie if it's reached at the same distance
+// from two different labels, or from a cell that's already a tie.
+//
+// Part 2 splits the total distance into x and y parts and works with
+// the two 1D functions, so it's O(W + H + N log N).  Unlike doit.cc it
+// also counts cells outside the bounding box.
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+using namespace std;
+
+using coords = pair<int, int>;
+
+enum status { unvisited = -2, boundary = -1 };
+
+struct grid {
+  // Original points
+  vector<coords> coordinates;
+  // Bounding box
+  coords ll;
+  coords ur;
+  int w, h;
+
+  // Construct from stdin
+  grid();
+
+  int index(int x, int y) const { return (y - ll.second) * w + (x - ll.first); }
+
+  int part1() const;
+  long part2() const;
+};
+
+grid::grid() {
+  char comma;
+  int x, y;
+  while (cin >> x >> comma >> y)
+    coordinates.emplace_back(x, y);
+  assert(!coordinates.empty());
+  ll = ur = coordinates.front();
+  for (auto const &[x, y] : coordinates) {
+    ll = { min(ll.first, x), min(ll.second, y) };
+    ur = { max(ur.first, x), max(ur.second, y) };
+  }
+  w = ur.first - ll.first + 1;
+  h = ur.second - ll.second + 1;
+}
+
+int grid::part1() const {
+  // closest[i] is the closest point for cell i (or boundary), dist[i]
+  // is the distance to it
+  vector<int> closest(w * h, unvisited);
+  vector<int> dist(w * h, 0);
+  vector<int> frontier;
+  for (size_t i = 0; i < coordinates.size(); ++i) {
+    int c = index(coordinates[i].first, coordinates[i].second);
+    if (closest[c] == unvisited) {
+      closest[c] = i;
+      frontier.push_back(c);
+    } else
+      // Duplicate point
+      closest[c] = boundary;
+  }
+  vector<int> next;
+  for (int d = 1; !frontier.empty(); ++d) {
+    next.clear();
+    for (int c : frontier) {
+      int x = c % w;
+      int y = c / w;
+      auto visit = [&](int n) {
+                     if (closest[n] == unvisited) {
+                       closest[n] = closest[c];
+                       dist[n] = d;
+                       next.push_back(n);
+                     } else if (dist[n] == d && closest[n] != closest[c])
+                       closest[n] = boundary;
+                   };
+      if (x > 0)
+        visit(c - 1);
+      if (x + 1 < w)
+        visit(c + 1);
+      if (y > 0)
+        visit(c - w);
+      if (y + 1 < h)
+        visit(c + w);
+    }
+    swap(frontier, next);
+  }
+  // Points whose index is on an edge have unbounded regions
+  vector<int> areas(coordinates.size(), 0);
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x) {
+      int index = closest[y * w + x];
+      assert(index != unvisited);
+      if (index == boundary)
+        continue;
+      if (x == 0 || x == w - 1 || y == 0 || y == h - 1)
+        // Reached edge
+        areas[index] = -1;
+      if (areas[index] < 0)
+        continue;
+      ++areas[index];
+    }
+  return *max_element(areas.begin(), areas.end());
+}
+
+// The 1D total distance function S(v) = sum |v - vi| for all v where
+// it's below threshold, which is a range around the coordinates that
+// grows by threshold / n on each side.  Returns the S(v) values in
+// increasing order.
+vector<long> total_distances(vector<int> vs, long threshold) {
+  sort(vs.begin(), vs.end());
+  long n = vs.size();
+  long lo = vs.front() - threshold / n - 1;
+  long hi = vs.back() + threshold / n + 1;
+  // S(lo), and then S(v + 1) = S(v) + (number of vi <= v) - (number
+  // of vi > v)
+  long s = 0;
+  for (int vi : vs)
+    s += vi - lo;
+  vector<long> result;
+  size_t at_or_below = 0;
+  for (long v = lo; v <= hi; ++v) {
+    if (s < threshold)
+      result.push_back(s);
+    while (at_or_below < vs.size() && vs[at_or_below] <= v)
+      ++at_or_below;
+    s += long(at_or_below) - (n - long(at_or_below));
+  }
+  if (result.empty())
+    return result;
+  // S is convex, so the values go down and then up.  Merge the two
+  // halves instead of sorting.
+  auto bottom = min_element(result.begin(), result.end());
+  vector<long> sorted(result.size());
+  merge(make_reverse_iterator(bottom + 1), result.rend(), bottom + 1,
+        result.end(), sorted.begin());
+  return sorted;
+}
+
+// The total distance is Sx(x) + Sy(y), so the count of (x, y) with
+// total below the threshold only needs the sorted 1D functions.  No
+// grid, and not clipped to the bounding box.
+long grid::part2() const {
+  long const threshold = 10000;
+  vector<int> xs, ys;
+  for (auto const &[x, y] : coordinates) {
+    xs.push_back(x);
+    ys.push_back(y);
+  }
+  auto sx = total_distances(xs, threshold);
+  auto sy = total_distances(ys, threshold);
+  // As Sx increases, the number of Sy values that fit decreases
+  long result = 0;
+  size_t fit = sy.size();
+  for (long x_part : sx) {
+    while (fit > 0 && x_part + sy[fit - 1] >= threshold)
+      --fit;
+    result += fit;
+  }
+  return result;
+}
+
+void part1() { cout << grid().part1() << '\n'; }
+void part2() { cout << grid().part2() << '\n'; }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
@@ -4,81 +4,197 @@
 // ./doit 2 < input  # part 2
 
 #include <iostream>
-#include <map>
-#include <set>
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
 #include <cassert>
 
 using namespace std;
 
-map<char, set<char>> needs;
-set<char> steps;
-
-void read() {
-  string _;
-  char before, after;
-  while (cin >> _ >> before >> _ >> _ >> _ >> _ >> _ >> after >> _ >> _) {
-    assert(before >= 'A' && before <= 'Z');
-    assert(after >= 'A' && after <= 'Z');
-    needs[after].insert(before);
-    steps.insert(before);
-    steps.insert(after);
+// Steps are interned as integers 0...n-1 in order of their names, so
+// integer order is the lexicographic order the problem wants.  The
+// dependencies are in compressed sparse row form: the steps enabled
+// by step s are enables[first_enabled[s] ... first_enabled[s + 1]).
+struct dag {
+  vector<string> names;
+  vector<int> first_enabled;
+  vector<int> enables;
+  // Number of steps that each step needs
+  vector<int> num_needs;
+
+  // Construct from stdin
+  dag();
+
+  int size() const { return names.size(); }
+};
+
+dag::dag() {
+  unordered_map<string, int> interned;
+  auto intern = [&](string const &name) {
+                  auto [p, inserted] = interned.emplace(name, names.size());
+                  if (inserted)
+                    names.push_back(name);
+                  return p->second;
+                };
+  vector<pair<int, int>> edges;
+  string _, before, after;
+  while (cin >> _ >> before >> _ >> _ >> _ >> _ >> _ >> after >> _ >> _)
+    edges.emplace_back(intern(before), intern(after));
+  // Renumber by name
+  vector<int> by_name(names.size());
+  for (size_t i = 0; i < by_name.size(); ++i)
+    by_name[i] = i;
+  sort(by_name.begin(), by_name.end(),
+       [&](int i, int j) { return names[i] < names[j]; });
+  vector<int> rank(names.size());
+  vector<string> sorted_names(names.size());
+  for (size_t r = 0; r < by_name.size(); ++r) {
+    rank[by_name[r]] = r;
+    sorted_names[r] = move(names[by_name[r]]);
   }
+  names = move(sorted_names);
+  for (auto &edge : edges)
+    edge = { rank[edge.first], rank[edge.second] };
+  // The same requirement might be listed more than once
+  sort(edges.begin(), edges.end());
+  edges.erase(unique(edges.begin(), edges.end()), edges.end());
+  first_enabled.assign(names.size() + 1, 0);
+  num_needs.assign(names.size(), 0);
+  for (auto [step1, step2] : edges) {
+    ++first_enabled[step1 + 1];
+    ++num_needs[step2];
+  }
+  for (size_t s = 0; s < names.size(); ++s)
+    first_enabled[s + 1] += first_enabled[s];
+  // Edges are sorted by the enabling step, so they're already in CSR
+  // order
+  enables.reserve(edges.size());
+  for (auto [_, step2] : edges)
+    enables.push_back(step2);
 }
 
-pair<string, int> assemble(int workers, int base_time) {
-  read();
-  // Time to do a given step
-  auto time_for = [=](char step) { return base_time + step - 'A' + 1; };
-  // When a step is completed, what steps might it enable?
-  map<char, set<char>> enables;
-  for (auto const & [step2, requirements] : needs)
-    for (char step1 : requirements)
-      enables[step1].insert(step2);
-  // The steps that are ready
-  set<char> ready = steps;
-  for (auto const & [step, _] : needs)
-    ready.erase(step);
+// A timing wheel of steps keyed by completion time.  Bucket i holds
+// the steps finishing at the time in [now, now + size) that's i mod
+// size, so there's no searching or rebalancing, and everything
+// finishing at the same tick comes out together.  The wheel grows if
+// a step is scheduled too far ahead.
+struct timing_wheel {
+  vector<vector<int>> buckets;
+  // Current time and number of steps in the wheel
+  int now{0};
+  size_t pending{0};
+
+  timing_wheel() : buckets(64) {}
+
+  bool empty() const { return pending == 0; }
+
+  // Add step finishing at time when >= now
+  void schedule(int when, int step);
+
+  // Advance to the next time something finishes and return the steps
+  // finishing then
+  vector<int> next_batch();
+
+private:
+  size_t bucket(int when) const { return size_t(when) % buckets.size(); }
+};
+
+void timing_wheel::schedule(int when, int step) {
+  assert(when >= now);
+  if (size_t(when - now) >= buckets.size()) {
+    // Grow and redistribute.  Everything pending is within the old
+    // size of now, so its time can be recovered from the bucket index.
+    size_t old_size = buckets.size();
+    vector<vector<int>> old_buckets(max(2 * old_size, size_t(when - now + 1)));
+    swap(buckets, old_buckets);
+    for (size_t i = 0; i < old_size; ++i) {
+      int t = now + (i + old_size - size_t(now) % old_size) % old_size;
+      for (int s : old_buckets[i])
+        buckets[bucket(t)].push_back(s);
+    }
+  }
+  buckets[bucket(when)].push_back(step);
+  ++pending;
+}
+
+vector<int> timing_wheel::next_batch() {
+  assert(!empty());
+  while (buckets[bucket(now)].empty())
+    ++now;
+  vector<int> batch;
+  swap(batch, buckets[bucket(now)]);
+  pending -= batch.size();
+  return batch;
+}
+
+// Returns the order steps finish in and the total time.  time_for
+// gives the time to do a given step.
+pair<vector<int>, int> assemble(dag const &steps, int workers,
+                                function<int(string const &)> time_for) {
+  // The steps that are ready, smallest (lexicographically first) on top
+  priority_queue<int, vector<int>, greater<int>> ready;
+  for (int step = 0; step < steps.size(); ++step)
+    if (steps.num_needs[step] == 0)
+      ready.push(step);
   // Remaining steps needed
-  auto remaining_needs = needs;
-  // When workers will finish their current steps
-  map<int, set<char>> finishing;
-  // Does anyone know what time it is?
-  int t = 0;
+  auto remaining_needs = steps.num_needs;
+  // When workers will finish their current steps.  Does anyone know
+  // what time it is?  finishing.now.
+  timing_wheel finishing;
   // The order of finishing steps
-  string order;
+  vector<int> order;
   while (!ready.empty() || !finishing.empty()) {
     if (workers > 0 && !ready.empty()) {
       // Start a step
-      char step = *ready.begin();
-      ready.erase(ready.begin());
+      int step = ready.top();
+      ready.pop();
       --workers;
-      finishing[t + time_for(step)].insert(step);
+      finishing.schedule(finishing.now + time_for(steps.names[step]), step);
       continue;
     }
     // Nothing is ready, or all workers are busy
     assert(!finishing.empty());
-    auto [tnext, done] = *finishing.begin();
-    finishing.erase(finishing.begin());
     // Time advances
-    t = tnext;
+    auto done = finishing.next_batch();
     // Workers become free again
     workers += done.size();
-    for (char step1 : done) {
+    // Steps finishing at the same time are noted in order
+    sort(done.begin(), done.end());
+    for (int step1 : done) {
       // Note steps as completed
       order.push_back(step1);
       // Enable next steps
-      for (char step2 : enables[step1]) {
-        remaining_needs[step2].erase(step1);
-        if (remaining_needs[step2].empty())
-          ready.insert(step2);
+      for (int i = steps.first_enabled[step1];
+           i < steps.first_enabled[step1 + 1]; ++i) {
+        int step2 = steps.enables[i];
+        if (--remaining_needs[step2] == 0)
+          ready.push(step2);
       }
     }
   }
-  return { order, t };
+  assert(int(order.size()) == steps.size());
+  return { order, finishing.now };
+}
+
+void part1() {
+  dag steps;
+  auto order = assemble(steps, 1, [](string const &) { return 0; }).first;
+  for (int step : order)
+    cout << steps.names[step];
+  cout << '\n';
 }
 
-void part1() { cout << assemble(1, 0).first << '\n'; }
-void part2() { cout << assemble(5, 60).second << '\n'; }
+void part2() {
+  auto time_for = [](string const &step) {
+                    assert(step.length() == 1);
+                    assert(step[0] >= 'A' && step[0] <= 'Z');
+                    return 60 + step[0] - 'A' + 1;
+                  };
+  cout << assemble(dag(), 5, time_for).second << '\n';
+}
 
 int main(int argc, char **argv) {
   if (argc != 2) {
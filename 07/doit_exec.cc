@@ -0,0 +1,440 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -pthread -o doit_exec doit_exec.cc
+// ./doit_exec 1 < input  # part 1
+// ./doit_exec 2 < input  # part 2
+
+// Alternative to doit.cc that actually runs the steps instead of just
+// simulating workers.  The same dag drives an executor that calls a
+// function for each step on a pool of threads, starting a step only
+// once everything it needs has finished.  By default each thread
+// keeps its own deque of ready steps and steals from the others when
+// it runs dry; optionally all threads share one ready heap so that
+// ties are broken lexicographically like assemble().  Either way the
+// executor returns a trace of real start and finish times.
+//
+// Part 1 runs deterministically on one thread and prints the order.
+// Part 2 runs the steps on 5 threads, with each step sleeping for its
+// time in milliseconds, and prints the simulated time from
+// assemble().  The trace and measured wall time go to stderr for
+// comparison.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cassert>
+
+using namespace std;
+
+// Steps are interned as integers 0...n-1 in order of their names, so
+// integer order is the lexicographic order the problem wants.  The
+// dependencies are in compressed sparse row form: the steps enabled
+// by step s are enables[first_enabled[s] ... first_enabled[s + 1]).
+struct dag {
+  vector<string> names;
+  vector<int> first_enabled;
+  vector<int> enables;
+  // Number of steps that each step needs
+  vector<int> num_needs;
+
+  // Construct from stdin
+  dag();
+
+  int size() const { return names.size(); }
+};
+
+dag::dag() {
+  unordered_map<string, int> interned;
+  auto intern = [&](string const &name) {
+                  auto [p, inserted] = interned.emplace(name, names.size());
+                  if (inserted)
+                    names.push_back(name);
+                  return p->second;
+                };
+  vector<pair<int, int>> edges;
+  string _, before, after;
+  while (cin >> _ >> before >> _ >> _ >> _ >> _ >> _ >> after >> _ >> _)
+    edges.emplace_back(intern(before), intern(after));
+  // Renumber by name
+  vector<int> by_name(names.size());
+  for (size_t i = 0; i < by_name.size(); ++i)
+    by_name[i] = i;
+  sort(by_name.begin(), by_name.end(),
+       [&](int i, int j) { return names[i] < names[j]; });
+  vector<int> rank(names.size());
+  vector<string> sorted_names(names.size());
+  for (size_t r = 0; r < by_name.size(); ++r) {
+    rank[by_name[r]] = r;
+    sorted_names[r] = move(names[by_name[r]]);
+  }
+  names = move(sorted_names);
+  for (auto &edge : edges)
+    edge = { rank[edge.first], rank[edge.second] };
+  // The same requirement might be listed more than once
+  sort(edges.begin(), edges.end());
+  edges.erase(unique(edges.begin(), edges.end()), edges.end());
+  first_enabled.assign(names.size() + 1, 0);
+  num_needs.assign(names.size(), 0);
+  for (auto [step1, step2] : edges) {
+    ++first_enabled[step1 + 1];
+    ++num_needs[step2];
+  }
+  for (size_t s = 0; s < names.size(); ++s)
+    first_enabled[s + 1] += first_enabled[s];
+  // Edges are sorted by the enabling step, so they're already in CSR
+  // order
+  enables.reserve(edges.size());
+  for (auto [_, step2] : edges)
+    enables.push_back(step2);
+}
+
+// A timing wheel of steps keyed by completion time.  Bucket i holds
+// the steps finishing at the time in [now, now + size) that's i mod
+// size, so there's no searching or rebalancing, and everything
+// finishing at the same tick comes out together.  The wheel grows if
+// a step is scheduled too far ahead.
+struct timing_wheel {
+  vector<vector<int>> buckets;
+  // Current time and number of steps in the wheel
+  int now{0};
+  size_t pending{0};
+
+  timing_wheel() : buckets(64) {}
+
+  bool empty() const { return pending == 0; }
+
+  // Add step finishing at time when >= now
+  void schedule(int when, int step);
+
+  // Advance to the next time something finishes and return the steps
+  // finishing then
+  vector<int> next_batch();
+
+private:
+  size_t bucket(int when) const { return size_t(when) % buckets.size(); }
+};
+
+void timing_wheel::schedule(int when, int step) {
+  assert(when >= now);
+  if (size_t(when - now) >= buckets.size()) {
+    // Grow and redistribute.  Everything pending is within the old
+    // size of now, so its time can be recovered from the bucket index.
+    size_t old_size = buckets.size();
+    vector<vector<int>> old_buckets(max(2 * old_size, size_t(when - now + 1)));
+    swap(buckets, old_buckets);
+    for (size_t i = 0; i < old_size; ++i) {
+      int t = now + (i + old_size - size_t(now) % old_size) % old_size;
+      for (int s : old_buckets[i])
+        buckets[bucket(t)].push_back(s);
+    }
+  }
+  buckets[bucket(when)].push_back(step);
+  ++pending;
+}
+
+vector<int> timing_wheel::next_batch() {
+  assert(!empty());
+  while (buckets[bucket(now)].empty())
+    ++now;
+  vector<int> batch;
+  swap(batch, buckets[bucket(now)]);
+  pending -= batch.size();
+  return batch;
+}
+
+// Returns the order steps finish in and the total time.  time_for
+// gives the time to do a given step.
+pair<vector<int>, int> assemble(dag const &steps, int workers,
+                                function<int(string const &)> time_for) {
+  // The steps that are ready, smallest (lexicographically first) on top
+  priority_queue<int, vector<int>, greater<int>> ready;
+  for (int step = 0; step < steps.size(); ++step)
+    if (steps.num_needs[step] == 0)
+      ready.push(step);
+  // Remaining steps needed
+  auto remaining_needs = steps.num_needs;
+  // When workers will finish their current steps.  Does anyone know
+  // what time it is?  finishing.now.
+  timing_wheel finishing;
+  // The order of finishing steps
+  vector<int> order;
+  while (!ready.empty() || !finishing.empty()) {
+    if (workers > 0 && !ready.empty()) {
+      // Start a step
+      int step = ready.top();
+      ready.pop();
+      --workers;
+      finishing.schedule(finishing.now + time_for(steps.names[step]), step);
+      continue;
+    }
+    // Nothing is ready, or all workers are busy
+    assert(!finishing.empty());
+    // Time advances
+    auto done = finishing.next_batch();
+    // Workers become free again
+    workers += done.size();
+    // Steps finishing at the same time are noted in order
+    sort(done.begin(), done.end());
+    for (int step1 : done) {
+      // Note steps as completed
+      order.push_back(step1);
+      // Enable next steps
+      for (int i = steps.first_enabled[step1];
+           i < steps.first_enabled[step1 + 1]; ++i) {
+        int step2 = steps.enables[i];
+        if (--remaining_needs[step2] == 0)
+          ready.push(step2);
+      }
+    }
+  }
+  assert(int(order.size()) == steps.size());
+  return { order, finishing.now };
+}
+
+struct trace_entry {
+  int step;
+  int worker;
+  // Times in seconds since the executor started
+  double start;
+  double finish;
+};
+
+struct executor {
+  dag const &steps;
+  int num_threads;
+  // Share one ready heap and always take the lexicographically first
+  // ready step, instead of work stealing
+  bool lexicographic;
+
+  executor(dag const &steps_, int num_threads_, bool lexicographic_ = false) :
+    steps(steps_), num_threads(num_threads_), lexicographic(lexicographic_) {}
+
+  // Run action for every step, returns the trace ordered by start
+  // time
+  vector<trace_entry> run(function<void(string const &)> const &action) const;
+
+private:
+  using clock = chrono::steady_clock;
+
+  vector<vector<trace_entry>>
+  run_lexicographic(function<void(string const &)> const &action,
+                    clock::time_point t0) const;
+  vector<vector<trace_entry>>
+  run_stealing(function<void(string const &)> const &action,
+               clock::time_point t0) const;
+};
+
+vector<trace_entry>
+executor::run(function<void(string const &)> const &action) const {
+  assert(num_threads > 0);
+  auto t0 = clock::now();
+  auto per_worker = lexicographic ?
+    run_lexicographic(action, t0) : run_stealing(action, t0);
+  vector<trace_entry> trace;
+  for (auto const &entries : per_worker)
+    trace.insert(trace.end(), entries.begin(), entries.end());
+  assert(int(trace.size()) == steps.size());
+  stable_sort(trace.begin(), trace.end(),
+       [](trace_entry const &e1, trace_entry const &e2) {
+         return e1.start < e2.start;
+       });
+  return trace;
+}
+
+vector<vector<trace_entry>>
+executor::run_lexicographic(function<void(string const &)> const &action,
+                            clock::time_point t0) const {
+  auto seconds = [&] {
+                   return chrono::duration<double>(clock::now() - t0).count();
+                 };
+  mutex m;
+  condition_variable changed;
+  priority_queue<int, vector<int>, greater<int>> ready;
+  for (int step = 0; step < steps.size(); ++step)
+    if (steps.num_needs[step] == 0)
+      ready.push(step);
+  auto remaining_needs = steps.num_needs;
+  int unfinished = steps.size();
+  vector<vector<trace_entry>> trace(num_threads);
+  auto worker = [&](int id) {
+                  unique_lock<mutex> lock(m);
+                  while (true) {
+                    changed.wait(lock, [&] {
+                                         return !ready.empty() || unfinished == 0;
+                                       });
+                    if (ready.empty())
+                      return;
+                    int step = ready.top();
+                    ready.pop();
+                    lock.unlock();
+                    double start = seconds();
+                    action(steps.names[step]);
+                    trace[id].push_back({ step, id, start, seconds() });
+                    lock.lock();
+                    --unfinished;
+                    for (int i = steps.first_enabled[step];
+                         i < steps.first_enabled[step + 1]; ++i) {
+                      int step2 = steps.enables[i];
+                      if (--remaining_needs[step2] == 0)
+                        ready.push(step2);
+                    }
+                    changed.notify_all();
+                  }
+                };
+  vector<thread> pool;
+  for (int id = 0; id < num_threads; ++id)
+    pool.emplace_back(worker, id);
+  for (auto &th : pool)
+    th.join();
+  return trace;
+}
+
+vector<vector<trace_entry>>
+executor::run_stealing(function<void(string const &)> const &action,
+                       clock::time_point t0) const {
+  auto seconds = [&] {
+                   return chrono::duration<double>(clock::now() - t0).count();
+                 };
+  // Each worker pushes and pops at the back of its own deque, thieves
+  // take from the front
+  struct work_queue {
+    mutex m;
+    deque<int> steps;
+  };
+  vector<work_queue> queues(num_threads);
+  vector<atomic<int>> remaining_needs(steps.size());
+  // Steps sitting in any of the queues.  Idle workers wait on
+  // work_available until there's something to steal or everything's
+  // done; both conditions are changed with idle_m held, so wakeups
+  // aren't lost.
+  atomic<int> queued{ 0 };
+  mutex idle_m;
+  condition_variable work_available;
+  int next_queue = 0;
+  for (int step = 0; step < steps.size(); ++step) {
+    remaining_needs[step] = steps.num_needs[step];
+    if (steps.num_needs[step] == 0) {
+      queues[next_queue].steps.push_back(step);
+      ++queued;
+      next_queue = (next_queue + 1) % num_threads;
+    }
+  }
+  atomic<int> unfinished{ steps.size() };
+  auto take = [&](int id) {
+                // Own work first
+                for (int i = 0; i < num_threads; ++i) {
+                  auto &q = queues[(id + i) % num_threads];
+                  lock_guard<mutex> lock(q.m);
+                  if (q.steps.empty())
+                    continue;
+                  int step;
+                  if (i == 0) {
+                    step = q.steps.back();
+                    q.steps.pop_back();
+                  } else {
+                    step = q.steps.front();
+                    q.steps.pop_front();
+                  }
+                  --queued;
+                  return step;
+                }
+                return -1;
+              };
+  vector<vector<trace_entry>> trace(num_threads);
+  auto worker = [&](int id) {
+                  while (unfinished > 0) {
+                    int step = take(id);
+                    if (step < 0) {
+                      unique_lock<mutex> lock(idle_m);
+                      work_available.wait(lock, [&] {
+                                                  return queued > 0 || unfinished == 0;
+                                                });
+                      continue;
+                    }
+                    double start = seconds();
+                    action(steps.names[step]);
+                    trace[id].push_back({ step, id, start, seconds() });
+                    for (int i = steps.first_enabled[step];
+                         i < steps.first_enabled[step + 1]; ++i) {
+                      int step2 = steps.enables[i];
+                      if (--remaining_needs[step2] == 0) {
+                        {
+                          lock_guard<mutex> lock(queues[id].m);
+                          queues[id].steps.push_back(step2);
+                        }
+                        {
+                          lock_guard<mutex> lock(idle_m);
+                          ++queued;
+                        }
+                        work_available.notify_one();
+                      }
+                    }
+                    // Only after the enabled steps are queued, so
+                    // nobody quits while there's still work
+                    if (--unfinished == 0) {
+                      lock_guard<mutex> lock(idle_m);
+                      work_available.notify_all();
+                    }
+                  }
+                };
+  vector<thread> pool;
+  for (int id = 0; id < num_threads; ++id)
+    pool.emplace_back(worker, id);
+  for (auto &th : pool)
+    th.join();
+  return trace;
+}
+
+void part1() {
+  dag steps;
+  auto trace = executor(steps, 1, true).run([](string const &) {});
+  for (auto const &entry : trace)
+    cout << steps.names[entry.step];
+  cout << '\n';
+}
+
+void part2() {
+  dag steps;
+  int const workers = 5;
+  auto time_for = [](string const &step) {
+                    assert(step.length() == 1);
+                    assert(step[0] >= 'A' && step[0] <= 'Z');
+                    return 60 + step[0] - 'A' + 1;
+                  };
+  int simulated = assemble(steps, workers, time_for).second;
+  cout << simulated << '\n';
+  // One time unit is a millisecond
+  auto trace = executor(steps, workers).run([&](string const &step) {
+                 this_thread::sleep_for(chrono::milliseconds(time_for(step)));
+               });
+  double wall = 0;
+  for (auto const &entry : trace) {
+    cerr << steps.names[entry.step] << " worker " << entry.worker
+         << ' ' << 1000 * entry.start << " - " << 1000 * entry.finish
+         << " ms\n";
+    wall = max(wall, entry.finish);
+  }
+  cerr << "simulated " << simulated << " ms, measured " << 1000 * wall
+       << " ms\n";
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
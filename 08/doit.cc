@@ -4,60 +4,101 @@
 // ./doit 2 < input  # part 2
 
 #include <iostream>
+#include <iterator>
+#include <string>
 #include <vector>
-#include <optional>
 #include <numeric>
+#include <cctype>
 #include <cassert>
 
 using namespace std;
 
-struct node {
-  vector<node> children;
+// The whole tree in flat arrays.  Nodes are numbered in the order
+// they appear in the input (preorder), so the root is 0 and children
+// always come after their parent.  Node n's children are
+// children[first_child[n] ... first_child[n] + num_children[n]) and
+// its metadata is metadata[first_metadata[n] ... first_metadata[n] +
+// num_metadata[n]).  Node values are worked out during parsing, since
+// a node's children are all complete by the time its metadata is
+// read.
+struct tree {
+  vector<int> first_child;
+  vector<int> num_children;
+  vector<int> first_metadata;
+  vector<int> num_metadata;
+  vector<int> children;
   vector<int> metadata;
+  vector<int> values;
 
-  node();
+  // Construct from stdin
+  tree();
+
+  int size() const { return first_child.size(); }
 
   int total_metadata() const;
-  int value() const;
+  int value() const { return values[0]; }
 };
 
-node::node() {
-  int num_children, num_metadata;
-  cin >> num_children >> num_metadata;
-  for (int _ = 0; _ < num_children; ++_)
-    children.emplace_back();
-  for (int _ = 0; _ < num_metadata; ++_) {
-    int data;
-    cin >> data;
-    metadata.push_back(data);
+tree::tree() {
+  string input{ istreambuf_iterator<char>(cin), istreambuf_iterator<char>() };
+  size_t pos = 0;
+  auto next = [&] {
+                while (pos < input.length() && !isdigit(input[pos]))
+                  ++pos;
+                assert(pos < input.length());
+                int result = 0;
+                for (; pos < input.length() && isdigit(input[pos]); ++pos)
+                  result = 10 * result + (input[pos] - '0');
+                return result;
+              };
+  // Read a node header and make space for its children
+  auto add_node = [&] {
+                    int n = size();
+                    first_child.push_back(children.size());
+                    num_children.push_back(next());
+                    num_metadata.push_back(next());
+                    first_metadata.push_back(0);
+                    values.push_back(0);
+                    children.resize(children.size() + num_children[n]);
+                    return n;
+                  };
+  // Stack of nodes being read, and how many of their children have
+  // been read so far
+  vector<pair<int, int>> stack;
+  stack.emplace_back(add_node(), 0);
+  while (!stack.empty()) {
+    auto &[n, read_children] = stack.back();
+    if (read_children < num_children[n]) {
+      int child = add_node();
+      children[first_child[n] + read_children++] = child;
+      // NB: invalidates n and read_children
+      stack.emplace_back(child, 0);
+      continue;
+    }
+    // Metadata follows the children
+    first_metadata[n] = metadata.size();
+    for (int _ = 0; _ < num_metadata[n]; ++_)
+      metadata.push_back(next());
+    auto begin = metadata.begin() + first_metadata[n];
+    auto end = metadata.end();
+    if (num_children[n] == 0)
+      values[n] = accumulate(begin, end, 0);
+    else
+      for (auto p = begin; p != end; ++p) {
+        int index = *p - 1;
+        if (0 <= index && index < num_children[n])
+          values[n] += values[children[first_child[n] + index]];
+      }
+    stack.pop_back();
   }
 }
 
-int node::total_metadata() const {
-  int result = accumulate(metadata.begin(), metadata.end(), 0);
-  for (auto const &child : children)
-    result += child.total_metadata();
-  return result;
-}
-
-int node::value() const {
-  if (children.empty())
-    return accumulate(metadata.begin(), metadata.end(), 0);
-  vector<optional<int>> children_values(children.size());
-  int result = 0;
-  for (int index : metadata) {
-    --index;
-    if (index < 0 || index >= int(children.size()))
-      continue;
-    if (!children_values[index])
-      children_values[index] = children[index].value();
-    result += *children_values[index];
-  }
-  return result;
+int tree::total_metadata() const {
+  return accumulate(metadata.begin(), metadata.end(), 0);
 }
 
-void part1() { cout << node().total_metadata() << '\n'; }
-void part2() { cout << node().value() << '\n'; }
+void part1() { cout << tree().total_metadata() << '\n'; }
+void part2() { cout << tree().value() << '\n'; }
 
 int main(int argc, char **argv) {
   if (argc != 2) {
@@ -0,0 +1,149 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -o doit_stream doit_stream.cc
+// ./doit_stream 1 < input  # part 1
+// ./doit_stream 2 < input  # part 2
+
+// Alternative to doit.cc that never builds the tree.  Both answers
+// can be computed bottom up as the numbers go by: a node's value is
+// known as soon as its metadata has been read, and all its parent
+// needs is that value.  So the only state is a stack of nodes that
+// are partly read, each with the values of its children so far.
+// Memory is bounded by depth times fan-out instead of input size.
+// The input is mapped rather than read when stdin is a file, and read
+// a chunk at a time otherwise.
+
+#include <iostream>
+#include <vector>
+#include <cctype>
+#include <cassert>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Input numbers from stdin, mapped if possible
+struct numbers {
+  // The part of the input that hasn't been looked at yet
+  char const *begin;
+  char const *end;
+  // For when stdin can't be mapped, the current chunk
+  vector<char> buffer;
+  size_t mapped{0};
+
+  numbers();
+  ~numbers();
+
+  int next();
+
+private:
+  // Read the next chunk when begin reaches end, false at end of input
+  bool refill();
+};
+
+numbers::numbers() {
+  struct stat st;
+  if (fstat(0, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, 0, 0);
+    if (p != MAP_FAILED) {
+      madvise(p, st.st_size, MADV_SEQUENTIAL);
+      mapped = st.st_size;
+      begin = static_cast<char const *>(p);
+      end = begin + mapped;
+      return;
+    }
+  }
+  buffer.resize(1 << 16);
+  begin = end = buffer.data();
+}
+
+numbers::~numbers() {
+  if (mapped)
+    munmap(const_cast<char *>(end - mapped), mapped);
+}
+
+bool numbers::refill() {
+  if (begin != end)
+    return true;
+  if (mapped)
+    return false;
+  ssize_t n = read(0, buffer.data(), buffer.size());
+  if (n <= 0)
+    return false;
+  begin = buffer.data();
+  end = begin + n;
+  return true;
+}
+
+int numbers::next() {
+  while (true) {
+    bool more = refill();
+    assert(more);
+    if (isdigit(*begin))
+      break;
+    ++begin;
+  }
+  // A number may carry on into the next chunk
+  int result = 0;
+  while (refill() && isdigit(*begin))
+    result = 10 * result + (*begin++ - '0');
+  return result;
+}
+
+struct partial_node {
+  int num_children;
+  int num_metadata;
+  vector<int> child_values;
+};
+
+// Returns { total metadata, root value }
+pair<long, int> solve() {
+  numbers input;
+  long total_metadata = 0;
+  vector<partial_node> stack;
+  auto start_node = [&] {
+                      int num_children = input.next();
+                      int num_metadata = input.next();
+                      stack.push_back({ num_children, num_metadata, {} });
+                      stack.back().child_values.reserve(num_children);
+                    };
+  start_node();
+  while (true) {
+    auto &top = stack.back();
+    if (int(top.child_values.size()) < top.num_children) {
+      start_node();
+      continue;
+    }
+    int sum = 0;
+    int value = 0;
+    for (int _ = 0; _ < top.num_metadata; ++_) {
+      int data = input.next();
+      sum += data;
+      int index = data - 1;
+      if (0 <= index && index < top.num_children)
+        value += top.child_values[index];
+    }
+    total_metadata += sum;
+    if (top.num_children == 0)
+      value = sum;
+    stack.pop_back();
+    if (stack.empty())
+      return { total_metadata, value };
+    stack.back().child_values.push_back(value);
+  }
+}
+
+void part1() { cout << solve().first << '\n'; }
+void part2() { cout << solve().second << '\n'; }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
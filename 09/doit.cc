@@ -5,56 +5,74 @@
 
 #include <iostream>
 #include <vector>
-#include <list>
+#include <string>
+#include <cstdint>
 #include <algorithm>
 
 using namespace std;
 
 using num = long;
-using iter = list<num>::iterator;
 
-list<num> circle;
-iter current;
+// The circle is a doubly-linked list threaded through arrays indexed
+// by marble number.  A game can be reused for any number of plays,
+// and only reallocates if it needs more marbles than it's seen
+// before.
+struct game {
+  vector<uint32_t> next_cw;
+  vector<uint32_t> next_ccw;
+  uint32_t current;
 
-iter clockwise(iter i) {
-  if (++i == circle.end())
-    i = circle.begin();
-  return i;
-}
+  // Returns the winning score
+  num play(int num_players, int last_marble);
 
-iter countercw(iter i) {
-  if (i == circle.begin())
-    i = circle.end();
-  return --i;
-}
+private:
+  // Place marble i, returns the points scored
+  num move(num i);
+};
 
-num move(num i) {
+num game::move(num i) {
   if (i % 23 != 0) {
-    current = circle.insert(clockwise(clockwise(current)), i);
+    // Insert between one and two clockwise of current
+    uint32_t before = next_cw[current];
+    uint32_t after = next_cw[before];
+    next_cw[before] = i;
+    next_ccw[i] = before;
+    next_cw[i] = after;
+    next_ccw[after] = i;
+    current = i;
     return 0;
   } else {
-    for (int _ = 0; _ < 6; ++_)
-      current = countercw(current);
-    iter to_remove = countercw(current);
-    num score = i + *to_remove;
-    circle.erase(to_remove);
-    return score;
+    uint32_t to_remove = current;
+    for (int _ = 0; _ < 7; ++_)
+      to_remove = next_ccw[to_remove];
+    uint32_t before = next_ccw[to_remove];
+    uint32_t after = next_cw[to_remove];
+    next_cw[before] = after;
+    next_ccw[after] = before;
+    current = after;
+    return i + to_remove;
   }
 }
 
+num game::play(int num_players, int last_marble) {
+  if (next_cw.size() < size_t(last_marble) + 1) {
+    next_cw.resize(last_marble + 1);
+    next_ccw.resize(last_marble + 1);
+  }
+  next_cw[0] = next_ccw[0] = current = 0;
+  vector<num> scores(num_players, 0);
+  for (num i = 0; i < last_marble; ++i)
+    scores[i % num_players] += move(i + 1);
+  return *max_element(scores.begin(), scores.end());
+}
+
 void play(bool x100) {
   string _;
   int num_players, last_marble;
   cin >> num_players >> _ >> _ >> _ >> _ >> _ >> last_marble >> _;
   if (x100)
     last_marble *= 100;
-  circle.clear();
-  circle.push_back(0);
-  current = circle.begin();
-  vector<num> scores(num_players, 0);
-  for (num i = 0; i < last_marble; ++i)
-    scores[i % num_players] += move(i + 1);
-  cout << *max_element(scores.begin(), scores.end()) << '\n';
+  cout << game().play(num_players, last_marble) << '\n';
 }
 
 void part1() { play(false); }
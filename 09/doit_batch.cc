@@ -0,0 +1,134 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -O2 -pthread -o doit_batch doit_batch.cc
+// ./doit_batch 1 < input  # part 1
+// ./doit_batch 2 < input  # part 2
+
+// Alternative to doit.cc for sweeping over many games.  Each input
+// line is a configuration in the usual format, and the games are
+// spread over a pool of threads.  Every thread reuses its own game,
+// so the circle arrays are only allocated once per thread.  Results
+// are printed as each game finishes, prefixed by the configuration's
+// line number (starting from 1), so they may come out of order.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+using namespace std;
+
+using num = long;
+
+// The circle is a doubly-linked list threaded through arrays indexed
+// by marble number.  A game can be reused for any number of plays,
+// and only reallocates if it needs more marbles than it's seen
+// before.
+struct game {
+  vector<uint32_t> next_cw;
+  vector<uint32_t> next_ccw;
+  uint32_t current;
+
+  // Returns the winning score
+  num play(int num_players, int last_marble);
+
+private:
+  // Place marble i, returns the points scored
+  num move(num i);
+};
+
+num game::move(num i) {
+  if (i % 23 != 0) {
+    // Insert between one and two clockwise of current
+    uint32_t before = next_cw[current];
+    uint32_t after = next_cw[before];
+    next_cw[before] = i;
+    next_ccw[i] = before;
+    next_cw[i] = after;
+    next_ccw[after] = i;
+    current = i;
+    return 0;
+  } else {
+    uint32_t to_remove = current;
+    for (int _ = 0; _ < 7; ++_)
+      to_remove = next_ccw[to_remove];
+    uint32_t before = next_ccw[to_remove];
+    uint32_t after = next_cw[to_remove];
+    next_cw[before] = after;
+    next_ccw[after] = before;
+    current = after;
+    return i + to_remove;
+  }
+}
+
+num game::play(int num_players, int last_marble) {
+  if (next_cw.size() < size_t(last_marble) + 1) {
+    next_cw.resize(last_marble + 1);
+    next_ccw.resize(last_marble + 1);
+  }
+  next_cw[0] = next_ccw[0] = current = 0;
+  vector<num> scores(num_players, 0);
+  for (num i = 0; i < last_marble; ++i)
+    scores[i % num_players] += move(i + 1);
+  return *max_element(scores.begin(), scores.end());
+}
+
+struct configuration {
+  int line;
+  int num_players;
+  int last_marble;
+};
+
+void play(bool x100) {
+  vector<configuration> configs;
+  string _;
+  int num_players, last_marble;
+  while (cin >> num_players >> _ >> _ >> _ >> _ >> _ >> last_marble >> _) {
+    if (x100)
+      last_marble *= 100;
+    configs.push_back({ int(configs.size()) + 1, num_players, last_marble });
+  }
+  // Longest games first, so no thread gets stuck with a big one at the
+  // end
+  stable_sort(configs.begin(), configs.end(),
+              [](configuration const &c1, configuration const &c2) {
+                return c1.last_marble > c2.last_marble;
+              });
+  int num_threads = max(1u, thread::hardware_concurrency());
+  atomic<size_t> next_config{ 0 };
+  mutex output;
+  auto worker = [&] {
+                  game g;
+                  for (size_t i = next_config++; i < configs.size();
+                       i = next_config++) {
+                    auto const &config = configs[i];
+                    num score = g.play(config.num_players, config.last_marble);
+                    lock_guard<mutex> lock(output);
+                    cout << config.line << ": " << score << endl;
+                  }
+                };
+  vector<thread> pool;
+  for (int i = 1; i < num_threads; ++i)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &th : pool)
+    th.join();
+}
+
+void part1() { play(false); }
+void part2() { play(true); }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
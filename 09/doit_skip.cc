@@ -0,0 +1,164 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -O2 -o doit_skip doit_skip.cc
+// ./doit_skip 1 < input  # part 1
+// ./doit_skip 2 < input  # part 2
+
+// Alternative to doit.cc that doesn't keep the circle at all.
+//
+// Look at the circle as a sequence D running clockwise from the
+// marble after current and ending with current.  Placing a normal
+// marble i takes the first marble a off the front and appends a, i
+// to the back (i goes between a and whatever was after it, and
+// becomes current).  So apart from the multiples of 23, D is a queue
+// that's consumed one marble per move and grows by two.
+//
+// Take a block of 23 marbles m+1 ... m+23 starting right after a
+// multiple of 23.  Let F[0...22) be the marbles popped off the front
+// by the 22 normal moves.  The back of D is then
+//   F[0], m+1, F[1], m+2, ..., F[21], m+22
+// and marble m+23 removes the marble 7 counterclockwise of current,
+// which is F[18].  The new current is m+19, and the six marbles after
+// it go back to the front of D:
+//   F[19], m+20, F[20], m+21, F[21], m+22
+// Those are the first six pops of the next block.  Net effect on the
+// queue per block: 16 pops from the front, and a record of 37 marbles
+// appended at the back:
+//   F[0], m+1, F[1], m+2, ..., F[17], m+18, m+19
+//
+// Every marble in the queue is thus either implicit (m+k for some
+// block), or an F value of some block, which is a marble popped from
+// an earlier position in the queue.  The position of any pop is
+// known, so any queue element can be found by chasing positions back
+// until reaching an implicit marble or the initial circle, with no
+// storage.  Positions shrink by a factor of about 37/16 each step, so
+// that's O(log n).  The only thing that matters for the score is
+// F[18] of each block, so the whole game is O(n/23 log n) time and
+// O(log n) memory beyond the scores.  The start of the game is played
+// normally until the circle is comfortably bigger than a block.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+using namespace std;
+
+using num = long;
+
+// Number of blocks of 23 to play directly before switching
+int const direct_blocks = 4;
+
+// Play marbles 1...last_marble directly, returns the circle as D
+// (clockwise from after current, ending with current), adding
+// scores.  This is the same circle as doit.cc.
+vector<num> play_direct(vector<num> &scores, num last_marble) {
+  vector<num> next_cw(last_marble + 1, 0);
+  vector<num> next_ccw(last_marble + 1, 0);
+  num current = 0;
+  for (num i = 1; i <= last_marble; ++i) {
+    if (i % 23 != 0) {
+      num before = next_cw[current];
+      num after = next_cw[before];
+      next_cw[before] = i;
+      next_ccw[i] = before;
+      next_cw[i] = after;
+      next_ccw[after] = i;
+      current = i;
+    } else {
+      num to_remove = current;
+      for (int _ = 0; _ < 7; ++_)
+        to_remove = next_ccw[to_remove];
+      num before = next_ccw[to_remove];
+      num after = next_cw[to_remove];
+      next_cw[before] = after;
+      next_ccw[after] = before;
+      current = after;
+      scores[(i - 1) % scores.size()] += i + to_remove;
+    }
+  }
+  vector<num> circle;
+  num marble = current;
+  do {
+    marble = next_cw[marble];
+    circle.push_back(marble);
+  } while (marble != current);
+  return circle;
+}
+
+struct skipping_game {
+  // The circle as D when the blocks start
+  vector<num> initial;
+  // Last multiple of 23 before the blocks start
+  num start;
+
+  // First marble in block b is m(b) + 1
+  num m(num b) const { return start + 23 * b; }
+
+  // Marble at position q of the queue (positions count from the start
+  // of initial)
+  num queue(num q) const;
+};
+
+num skipping_game::queue(num q) const {
+  num const L0 = initial.size();
+  while (true) {
+    if (q < L0)
+      return initial[q];
+    num r = (q - L0) / 37;
+    num p = (q - L0) % 37;
+    if (p == 36)
+      return m(r) + 19;
+    if (p % 2 == 1)
+      return m(r) + p / 2 + 1;
+    // F[j] of block r
+    num b = r;
+    num j = p / 2;
+    if (j < 6 && b > 0) {
+      // One of the six carried from the previous block
+      if (j % 2 == 1)
+        return m(b - 1) + 20 + j / 2;
+      j = 19 + j / 2;
+      --b;
+    }
+    // Block b pops queue positions 16b + 6 ... 16b + 21 as F[6...22),
+    // and block 0 also pops 0...6 as F[0...6)
+    q = 16 * b + j;
+  }
+}
+
+void play(bool x100) {
+  string _;
+  int num_players, last_marble;
+  cin >> num_players >> _ >> _ >> _ >> _ >> _ >> last_marble >> _;
+  num last = last_marble;
+  if (x100)
+    last *= 100;
+  vector<num> scores(num_players, 0);
+  num direct = min<num>(last, 23 * direct_blocks);
+  skipping_game g{ play_direct(scores, direct), direct };
+  assert(direct == last || g.initial.size() >= 22);
+  // Marbles after the last full block only go into the circle and
+  // don't score
+  for (num b = 0; g.m(b) + 23 <= last; ++b) {
+    num i = g.m(b) + 23;
+    scores[(i - 1) % num_players] += i + g.queue(16 * b + 18);
+  }
+  cout << *max_element(scores.begin(), scores.end()) << '\n';
+}
+
+void part1() { play(false); }
+void part2() { play(true); }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
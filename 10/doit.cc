@@ -7,10 +7,9 @@
 #include <sstream>
 #include <string>
 #include <vector>
-#include <map>
-#include <set>
 #include <optional>
 #include <algorithm>
+#include <cstdint>
 #include <cassert>
 
 using namespace std;
@@ -59,98 +58,137 @@ vector<point> read() {
 }
 
 // The idea is that when alignment occurs, points are grouped together
-// to make characters.  Some pairs of points will become horizontally
-// adjacent.  candidate_time see if there's a t where pt1 and pt2 are
-// side-by-side (with pt1 on the left).  The function is called with
-// both orders of pt1 and pt2, so if the two points will ever align
-// side-by-side, that time will be found.
-optional<int> candidate_time(point const &pt1, point const &pt2) {
-  auto [p1, v1] = pt1;
-  auto [p2, v2] = pt2;
-  // How much x displacement has to occur?
-  int dx = p2.first - (p1.first + 1);
-  // How fast is the x distance changing?
-  int vx = v2.first - v1.first;
-  if (vx == 0)
-    // Distance unchanging
-    return nullopt;
-  int t = -dx / vx;
-  if (t < 0)
-    // In the past
-    return nullopt;
-  if (p1 + t * v1 + coords({ 1, 0 }) != p2 + t * v2)
-    // Not exactly aligned (i.e., vx didn't evenly divide dx)
-    return nullopt;
-  return t;
+// to make characters, so the bounding box is as small as it ever
+// gets.  The width of the bounding box at time t is the max of some
+// linear functions minus the min of some others, so it's convex in t.
+// Same for the height, so the half perimeter is convex too and can be
+// minimized by ternary search over integer t.
+long half_perimeter(vector<point> const &pts, long t) {
+  long minx = pts[0].first.first + t * pts[0].second.first;
+  long maxx = minx;
+  long miny = pts[0].first.second + t * pts[0].second.second;
+  long maxy = miny;
+  for (auto const & [p, v] : pts) {
+    long x = p.first + t * v.first;
+    long y = p.second + t * v.second;
+    minx = min(minx, x);
+    maxx = max(maxx, x);
+    miny = min(miny, y);
+    maxy = max(maxy, y);
+  }
+  return (maxx - minx) + (maxy - miny);
+}
+
+// Time >= 0 when the bounding box is smallest
+int smallest_time(vector<point> const &pts) {
+  // Convexity means that once the size stops going down, the minimum
+  // has been passed.  Double to find an upper bound.
+  long lo = 0;
+  long hi = 1;
+  while (half_perimeter(pts, 2 * hi) < half_perimeter(pts, hi))
+    hi *= 2;
+  hi *= 2;
+  while (hi - lo > 2) {
+    long m1 = lo + (hi - lo) / 3;
+    long m2 = hi - (hi - lo) / 3;
+    long f1 = half_perimeter(pts, m1);
+    long f2 = half_perimeter(pts, m2);
+    if (f1 < f2)
+      hi = m2 - 1;
+    else if (f1 > f2)
+      lo = m1 + 1;
+    else {
+      // The minimum is between m1 and m2, but a plateau might be
+      // making f1 == f2
+      lo = m1;
+      hi = m2;
+      if (m2 - m1 <= 2)
+        break;
+    }
+  }
+  long best = lo;
+  for (long t = lo + 1; t <= hi; ++t)
+    if (half_perimeter(pts, t) < half_perimeter(pts, best))
+      best = t;
+  return best;
 }
 
+// Biggest bounding box (in cells) that check_alignment will
+// rasterize.  Letters are small, so anything bigger isn't a message.
+long const max_raster = 1 << 26;
+
 // See if the points make a good constellation at time t, and
 // optionally display the constellation.
 bool check_alignment(vector<point> const &pts, int t, bool print) {
   // Where are the points at time t?
-  set<coords> pts_at_t;
-  for (auto const &pt : pts) {
-    auto pt_at_t = pt.first + t * pt.second;
-    pts_at_t.insert(pt_at_t);
+  vector<coords> pts_at_t;
+  pts_at_t.reserve(pts.size());
+  for (auto const &pt : pts)
+    pts_at_t.push_back(pt.first + t * pt.second);
+  coords ll = pts_at_t.front();
+  coords ur = ll;
+  for (auto const &pt_at_t : pts_at_t) {
+    ll = min(ll, pt_at_t);
+    ur = max(ur, pt_at_t);
   }
-  // Check for isolated points at that time
+  long w = long(ur.first) - ll.first + 1;
+  long h = long(ur.second) - ll.second + 1;
+  if (w * h > max_raster)
+    return false;
+  // Rasterize into rows of 64-bit words, bit x % 64 of word x / 64
+  // for column x.  Rows are padded with an empty row above and below
+  // and an empty word on each end so neighbor tests need no bounds
+  // checks.
+  long words = (w + 63) / 64 + 2;
+  vector<uint64_t> bitmap((h + 2) * words, 0);
+  auto row = [&](long y) { return &bitmap[(y + 1) * words + 1]; };
   for (auto const &pt_at_t : pts_at_t) {
-    int neighbors = 0;
-    for (int dx = -1; dx <= 1; ++dx)
-      for (int dy = -1; dy <= 1; ++dy)
-        if (pts_at_t.count(pt_at_t + coords({ dx, dy })))
-          ++neighbors;
-    if (neighbors < 2)
-      // The point itself is counted, so non-isolated is 2+
-      return false;
+    long x = pt_at_t.first - ll.first;
+    long y = pt_at_t.second - ll.second;
+    row(y)[x / 64] |= uint64_t(1) << (x % 64);
   }
-  if (print) {
-    coords ll = *pts_at_t.begin();
-    coords ur = ll;
-    for (auto const &pt_at_t : pts_at_t) {
-      ll = min(ll, pt_at_t);
-      ur = max(ur, pt_at_t);
+  // Check for isolated points.  A point's neighbors are the OR of the
+  // rows above, at, and below it, each shifted left and right by one
+  // column; the point itself doesn't count.
+  auto spread = [](uint64_t const *r, long i) {
+                  return r[i] | (r[i] << 1) | (r[i - 1] >> 63) |
+                    (r[i] >> 1) | (r[i + 1] << 63);
+                };
+  for (long y = 0; y < h; ++y) {
+    uint64_t const *above = row(y - 1);
+    uint64_t const *here = row(y);
+    uint64_t const *below = row(y + 1);
+    for (long i = 0; i < words - 2; ++i) {
+      uint64_t neighbors = spread(above, i) | spread(below, i) |
+        (here[i] << 1) | (here[i - 1] >> 63) |
+        (here[i] >> 1) | (here[i + 1] << 63);
+      if (here[i] & ~neighbors)
+        return false;
     }
-    for (int y = ll.second; y <= ur.second; ++y) {
-      for (int x = ll.first; x <= ur.first; ++x)
-        cout << (pts_at_t.count({ x, y }) ? "@@" : "  ");
+  }
+  if (print)
+    for (long y = 0; y < h; ++y) {
+      uint64_t const *r = row(y);
+      for (long x = 0; x < w; ++x)
+        cout << ((r[x / 64] >> (x % 64)) & 1 ? "@@" : "  ");
       cout << '\n';
     }
-  }
   // Alignment found
   return true;
 }
 
 int align(bool print) {
   auto pts = read();
-  // Find candidate alignment times, count how many times each
-  // candidate is found
-  map<int, int> candidates;
-  for (size_t i = 0; i < pts.size(); ++i)
-    for (size_t j = 0; j < pts.size(); ++j)
-      if (i != j) {
-        auto t = candidate_time(pts[i], pts[j]);
-        if (t)
-          ++candidates[*t];
-      }
-  // Most likely alignment times are those that are found the most
-  vector<pair<int, int>> by_occurrences(candidates.begin(), candidates.end());
-  sort(by_occurrences.begin(), by_occurrences.end(),
-       [](auto const &i1, auto const &i2) {
-         return i1.second < i2.second;
-       });
-  // Check in order of most likely
-  optional<int> t_aligned;
-  while (!by_occurrences.empty()) {
-    int t = by_occurrences.back().first;
-    by_occurrences.pop_back();
-    if (check_alignment(pts, t, print)) {
-      t_aligned = t;
-      break;
-    }
-  }
-  assert(t_aligned);
-  return *t_aligned;
+  assert(!pts.empty());
+  int t = smallest_time(pts);
+  // The letters might not quite be at the exact minimum if the
+  // message's own shape makes the box a little smaller just before
+  // or after, so check nearby as well
+  for (int dt : { 0, -1, 1, -2, 2 })
+    if (t + dt >= 0 && check_alignment(pts, t + dt, print))
+      return t + dt;
+  assert(false);
+  return -1;
 }
 
 void part1() { align(true); }
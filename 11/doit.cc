@@ -1,67 +1,109 @@
 // -*- C++ -*-
-// g++ -std=c++17 -Wall -g -o doit doit.cc
+// g++ -std=c++17 -Wall -g -O3 -pthread -o doit doit.cc
 // ./doit 1 < input  # part 1
 // ./doit 2 < input  # part 2
 
+// Input is the serial number, optionally followed by the grid size
+// (default 300)
+
 #include <iostream>
-#include <array>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <atomic>
 #include <cassert>
 
 using namespace std;
 
-int const n = 300;
+// Sizes per unit of work in largest_any_square
+int const size_band = 8;
+// Columns per block in largest_squares
+int const block_cols = 2048;
 
 struct grid {
-  // Computed power levels
-  array<array<int, n>, n> power;
-  // Partial sums of power[][]; accum[i][j] is the sum of
-  // power[0...i][0...j]
-  array<array<int, n>, n> accum;
+  // Grid is n x n
+  int n;
+  // Partial sums of power levels, padded with a zero row and column;
+  // accum[i * (n + 1) + j] is the sum of power[0...i-1][0...j-1].  The
+  // power levels themselves aren't stored.
+  vector<long> accum;
+  // Largest single cell power
+  int max_power;
 
-  // Reads serial number from stdin
+  // Reads serial number and optional size from stdin
   grid();
 
+  // Row i of accum
+  long const *row(int i) const { return &accum[long(i) * (n + 1)]; }
+
   // Power in a square of size sz with corner at (x, y).  NB: x and y
   // are normal 0-indexed
-  int square_power(int x, int y, int sz) const;
+  long square_power(int x, int y, int sz) const;
+
+  // Best square for one size: power and 0-indexed corner
+  struct best_square {
+    long power;
+    int x, y;
+
+    // Which is better, with ties going to the first square in x-major
+    // order
+    bool better_than(best_square const &other) const {
+      if (power != other.power)
+        return power > other.power;
+      return make_pair(x, y) < make_pair(other.x, other.y);
+    }
+  };
+
+  // Find the best square for each size sz_lo...sz_hi
+  vector<best_square> largest_squares(int sz_lo, int sz_hi) const;
 
   // Find the largest total power of any square of size sz.  Return
   // the 1-indexed (x, y) of the square's corner and the square's
   // power..
-  pair<pair<int, int>, int> largest_square(int sz) const;
+  pair<pair<int, int>, long> largest_square(int sz) const;
+
+  // Find the largest total power of any square of any size.  Return
+  // the 1-indexed (x, y) of the square's corner, the size, and the
+  // power.
+  tuple<pair<int, int>, int, long> largest_any_square() const;
 };
 
 grid::grid() {
-  int serial_num;
+  long serial_num;
   cin >> serial_num;
-  for (int x = 1; x <= n; ++x)
+  if (!(cin >> n))
+    n = 300;
+  assert(n > 0);
+  accum.assign(long(n + 1) * (n + 1), 0);
+  max_power = numeric_limits<int>::min();
+  // Build a row at a time from the previous row, computing power
+  // levels as they're needed
+  for (int x = 1; x <= n; ++x) {
+    long const *prev = row(x - 1);
+    long *cur = &accum[long(x) * (n + 1)];
+    long rack_id = x + 10;
+    long ysum = 0;
     for (int y = 1; y <= n; ++y) {
-      int rack_id = x + 10;
-      int power_level = rack_id * y;
+      long power_level = rack_id * y;
       power_level += serial_num;
       power_level *= rack_id;
       power_level %= 1000;
       power_level /= 100;
       power_level -= 5;
-      power[x - 1][y - 1] = power_level;
-    }
-  for (int i=0; i< n; ++i)  for (int j=0; j< n; ++j) accum[i][j]=-9;
-  for (int i = 0; i < n; ++i) {
-    int jsum = power[i][0];
-    accum[i][0] = (i > 0 ? accum[i - 1][0] : 0) + jsum;
-    for (int j = 1; j < n; ++j) {
-      jsum += power[i][j];
-      accum[i][j] = (i > 0 ? accum[i - 1][j] : 0) + jsum;
+      max_power = max(max_power, int(power_level));
+      ysum += power_level;
+      cur[y] = prev[y] + ysum;
     }
   }
 }
 
 // To find the sum in the square S, start with the sum from accum at
-// the corner C.  If the top rectangle with corner A is nonempty,
-// subtract off that.  If the left rectangle with corner B is
-// nonempty, subtract off that too.  If both rectangles are nonempty,
-// we've then subtracted the rectangle ending at (x, y) twice, so add
-// it back once.
+// the corner C.  Subtract off the top rectangle with corner A and the
+// left rectangle with corner B.  That subtracts the rectangle ending
+// at (x, y) twice, so add it back once.  The zero padding in accum
+// takes care of empty rectangles at the edges.
 //
 // +-------+--------------+
 // |   +   |      -       |
@@ -75,31 +117,99 @@ grid::grid() {
 // +-------B------sz------C
 //
 // Note: 0-indexed coordinates here
-int grid::square_power(int x, int y, int sz) const {
-  int total = accum[x + (sz - 1)][y + (sz - 1)];
-  if (x > 0)
-    total -= accum[x - 1][y + (sz - 1)];
-  if (y > 0)
-    total -= accum[x + (sz - 1)][y - 1];
-  if (x > 0 && y > 0)
-    total += accum[x - 1][y - 1];
-  return total;
+long grid::square_power(int x, int y, int sz) const {
+  return row(x + sz)[y + sz] - row(x)[y + sz] - row(x + sz)[y] + row(x)[y];
 }
 
-pair<pair<int, int>, int> grid::largest_square(int sz) const {
-  assert(sz <= n);
-  pair<int, int> result{ 0, 0 };
-  int largest = square_power(result.first, result.second, sz);
-  for (int x = 0; x + sz - 1 < n; ++x)
-    for (int y = 0; y + sz - 1 < n; ++y) {
-      int this_power = square_power(x, y, sz);
-      if (largest < this_power) {
-        largest = this_power;
-        result = { x, y };
+// Squares of size sz with corner x use rows x and x + sz of accum.
+// For a band of sizes, consecutive x share most of those rows, so
+// work through the columns in blocks, and within a block go through
+// every x and every size.  The rows for a band then stay in cache
+// for a whole block.  Within a row, the four lookups for a run of
+// squares are contiguous, so they're computed into row_power with a
+// loop that vectorizes.
+vector<grid::best_square> grid::largest_squares(int sz_lo, int sz_hi) const {
+  assert(1 <= sz_lo && sz_lo <= sz_hi && sz_hi <= n);
+  vector<best_square> result;
+  for (int sz = sz_lo; sz <= sz_hi; ++sz)
+    result.push_back({ square_power(0, 0, sz), 0, 0 });
+  vector<long> row_power(block_cols);
+  for (int y0 = 0; y0 + sz_lo <= n; y0 += block_cols)
+    for (int x = 0; x + sz_lo <= n; ++x) {
+      long const *a0 = row(x);
+      for (int sz = sz_lo; sz <= sz_hi && x + sz <= n; ++sz) {
+        long const *a1 = row(x + sz);
+        int y1 = min(y0 + block_cols, n - sz + 1);
+        if (y1 <= y0)
+          break;
+        for (int y = y0; y < y1; ++y)
+          row_power[y - y0] =
+            a1[y + sz] - a0[y + sz] - a1[y] + a0[y];
+        int y = max_element(row_power.begin(), row_power.begin() + (y1 - y0)) -
+          row_power.begin();
+        best_square here{ row_power[y], x, y0 + y };
+        auto &best = result[sz - sz_lo];
+        if (here.better_than(best))
+          best = here;
       }
     }
+  return result;
+}
+
+pair<pair<int, int>, long> grid::largest_square(int sz) const {
+  auto best = largest_squares(sz, sz).front();
   // Return 1-indexed coordinates to match the problem output
-  return { { result.first + 1, result.second + 1 }, largest };
+  return { { best.x + 1, best.y + 1 }, best.power };
+}
+
+tuple<pair<int, int>, int, long> grid::largest_any_square() const {
+  // Bands of sizes are handed out to threads in increasing order.
+  // Since no square of size sz can have more than max_power * sz^2,
+  // bands where that can't beat the best so far are skipped.
+  atomic<int> next_band{ 0 };
+  atomic<long> best_so_far{ numeric_limits<long>::min() };
+  int num_threads = max(1u, thread::hardware_concurrency());
+  // Each thread's best { power, -size, corner }
+  vector<tuple<long, int, pair<int, int>>> bests(num_threads);
+  auto worker = [&](int id) {
+                  auto &best = bests[id];
+                  best = { numeric_limits<long>::min(), 0, { 0, 0 } };
+                  for (int band = next_band++; band * size_band < n;
+                       band = next_band++) {
+                    int sz_lo = band * size_band + 1;
+                    int sz_hi = min(n, sz_lo + size_band - 1);
+                    // The bound is largest at the big end of the band
+                    // unless every cell is negative
+                    long bound = long(max_power) *
+                      (max_power >= 0 ? sz_hi * sz_hi : sz_lo * sz_lo);
+                    if (bound < best_so_far)
+                      continue;
+                    auto squares = largest_squares(sz_lo, sz_hi);
+                    for (int sz = sz_lo; sz <= sz_hi; ++sz) {
+                      auto const &square = squares[sz - sz_lo];
+                      // Ties go to the smaller size
+                      best = max(best, { square.power, -sz,
+                                         { square.x + 1, square.y + 1 } });
+                      long seen = best_so_far;
+                      while (seen < square.power &&
+                             !best_so_far.compare_exchange_weak(seen, square.power))
+                        ;
+                    }
+                  }
+                };
+  vector<thread> pool;
+  for (int id = 1; id < num_threads; ++id)
+    pool.emplace_back(worker, id);
+  worker(0);
+  for (auto &th : pool)
+    th.join();
+  auto [power, neg_sz, xy] = *max_element(bests.begin(), bests.end(),
+                                          [](auto const &b1, auto const &b2) {
+                                            return get<0>(b1) < get<0>(b2) ||
+                                              (get<0>(b1) == get<0>(b2) &&
+                                               get<1>(b1) < get<1>(b2));
+                                          });
+  return { xy, -neg_sz, power };
 }
 
 void part1() {
@@ -108,19 +218,8 @@ void part1() {
 }
 
 void part2() {
-  grid g;
-  auto [best_xy, best_power] = g.largest_square(1);
-  int best_sz = 1;
-  for (int sz = 2; sz <= n; ++sz) {
-    auto [this_xy, this_power] = g.largest_square(sz);
-    if (best_power < this_power) {
-      best_power = this_power;
-      best_xy = this_xy;
-      best_sz = sz;
-    }
-  }
-  auto [x, y] = best_xy;
-  cout << x << ',' << y << ',' << best_sz << '\n';
+  auto [xy, sz, _] = grid().largest_any_square();
+  cout << xy.first << ',' << xy.second << ',' << sz << '\n';
 }
 
 int main(int argc, char **argv) {
@@ -5,18 +5,24 @@
 
 #include <iostream>
 #include <string>
-#include <set>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 #include <cassert>
 
 using namespace std;
 
 struct pots {
-  // Number of the leftmost represented pot
-  int leftmost{0};
-  // What's growing in the represented pots
-  string state;
-  // Rules that produce plants
-  set<string> fertile;
+  // Number of the pot in bit 0 of state[0]
+  long leftmost{0};
+  // What's growing in the represented pots, 64 per word, pot leftmost
+  // + 64 * i + j in bit j of state[i].  Kept normalized so that bit 0
+  // of state[0] is always a plant and the last word isn't empty.
+  vector<uint64_t> state;
+  // Rules that produce plants.  Bit i is set if the pattern with
+  // index i produces a plant, where the index of a pattern of pots
+  // p-2 ... p+2 is p-2 as the high bit down to p+2 as the low bit.
+  uint32_t fertile{0};
 
   // Construct from stdin
   pots();
@@ -26,51 +32,103 @@ struct pots {
   // state can be shifting along.)
   bool grow();
 
+  // Shift state so that it's normalized, adjusting leftmost
+  void normalize(vector<uint64_t> &next);
+
   // Do the growing pot number sum thing
-  int plant_pots() const;
+  long plant_pots() const;
 };
 
 pots::pots() {
-  string _;
-  cin >> _ >> _ >> state;
+  string _, initial;
+  cin >> _ >> _ >> initial;
+  state.assign((initial.length() + 63) / 64, 0);
+  for (size_t i = 0; i < initial.length(); ++i)
+    if (initial[i] == '#')
+      state[i / 64] |= uint64_t(1) << (i % 64);
   string pattern;
   char next;
   while (cin >> pattern >> _ >> next) {
     assert(pattern.length() == 5);
     assert(next == '#' || next == '.');
+    int index = 0;
+    for (char c : pattern)
+      index = 2 * index + (c == '#');
     if (next == '#')
-      fertile.insert(pattern);
+      fertile |= uint32_t(1) << index;
   }
-  assert(!fertile.count("....."));
+  assert(!(fertile & 1));
+  auto normalized = state;
+  normalize(normalized);
+  state = normalized;
 }
 
-bool pots::grow() {
-  // Make sure there's room to check the rules
-  string extended = "..." + state + "...";
-  leftmost -= 3;
-  // next is overwritten with the new state
-  string next = extended;
-  for (size_t i = 2; i + 2 < next.length(); ++i)
-    // Apply rules
-    next[i] = fertile.count(extended.substr(i - 2, 5)) ? '#' : '.';
-  // Trim as much as possible
-  while (!next.empty() && next.back() == '.')
+void pots::normalize(vector<uint64_t> &next) {
+  size_t first = 0;
+  while (first < next.size() && next[first] == 0)
+    ++first;
+  assert(first < next.size());
+  int shift = __builtin_ctzll(next[first]);
+  leftmost += 64 * first + shift;
+  for (size_t i = first; i < next.size(); ++i) {
+    uint64_t word = next[i] >> shift;
+    if (shift > 0 && i + 1 < next.size())
+      word |= next[i + 1] << (64 - shift);
+    next[i - first] = word;
+  }
+  next.resize(next.size() - first);
+  while (next.back() == 0)
     next.pop_back();
-  auto pos = next.find('#');
-  assert(pos != string::npos);
-  next = next.substr(pos);
-  // Adjust leftmost and note if the state is unchanged
+}
+
+bool pots::grow() {
+  // Make sure there's room for plants to spread two pots either way
+  // by adding an empty word at each end
+  size_t n = state.size() + 2;
+  auto word = [&](size_t i) {
+                return 0 < i && i < n - 1 ? state[i - 1] : uint64_t(0);
+              };
+  leftmost -= 64;
+  // Truth table of the rules, each entry all ones or all zeros
+  uint64_t table[32];
+  for (int i = 0; i < 32; ++i)
+    table[i] = (fertile >> i) & 1 ? ~uint64_t(0) : 0;
+  vector<uint64_t> next(n);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t prev = i > 0 ? word(i - 1) : 0;
+    uint64_t here = word(i);
+    uint64_t after = i + 1 < n ? word(i + 1) : 0;
+    // Bit j of each of these is pot j's neighbor at that offset, from
+    // the high bit of the rule index down to the low bit
+    uint64_t vars[5] = {
+      (here << 2) | (prev >> 62),
+      (here << 1) | (prev >> 63),
+      here,
+      (here >> 1) | (after << 63),
+      (here >> 2) | (after << 62)
+    };
+    // Apply rules to 64 pots at once, selecting from the truth table
+    // one variable at a time starting with the low bit
+    uint64_t level[32];
+    copy(table, table + 32, level);
+    for (int v = 4, width = 16; v >= 0; --v, width /= 2)
+      for (int k = 0; k < width; ++k)
+        level[k] = (vars[v] & level[2 * k + 1]) | (~vars[v] & level[2 * k]);
+    next[i] = level[0];
+  }
+  // Trim as much as possible, adjust leftmost, and note if the state
+  // is unchanged
+  normalize(next);
   bool repeating = state == next;
   state = next;
-  leftmost += pos;
   return repeating;
 }
 
-int pots::plant_pots() const {
-  int result = 0;
-  for (size_t i = 0; i < state.length(); ++i)
-    if (state[i] == '#')
-      result += i + leftmost;
+long pots::plant_pots() const {
+  long result = 0;
+  for (size_t i = 0; i < state.size(); ++i)
+    for (uint64_t word = state[i]; word != 0; word &= word - 1)
+      result += leftmost + 64 * long(i) + __builtin_ctzll(word);
   return result;
 }
 
@@ -0,0 +1,434 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -O2 -o doit_hashlife doit_hashlife.cc
+// ./doit_hashlife 1 < input  # part 1
+// ./doit_hashlife 2 < input  # part 2
+
+// Alternative to doit.cc that handles any rules, not just ones that
+// settle into a single shape moving along.
+//
+// First the pots are grown a generation at a time (as in doit.cc)
+// while looking for any repeated shape.  If the shape at generation
+// g is the shape at an earlier generation g1 shifted by d, the
+// pattern is periodic with period g - g1 and shift d, and the sum at
+// any later generation follows directly.
+//
+// If no cycle shows up soon enough, the rest of the generations are
+// done with a 1D version of Hashlife.  Runs of pots are hash-consed
+// into a binary tree, where a node at level k covers 2^k pots.  The
+// state of a node's middle half 2^(k-3) generations later depends
+// only on the node, so it's computed once and memoized.  That
+// recursively skips 2^j generations at a time for any j, so the
+// generations are done as a sum of powers of two.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <tuple>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+using namespace std;
+
+// Generations to grow directly while looking for a cycle
+long const max_direct = 1 << 16;
+
+// Apply rules to 64 pots at once.  fertile is the truth table of the
+// rules, and bit j of vars[0] ... vars[4] are pot j's neighbors from
+// p-2 to p+2.  Select from the truth table one variable at a time
+// starting with the low bit.
+uint64_t apply_rules(uint32_t fertile, uint64_t const vars[5]) {
+  uint64_t level[32];
+  for (int i = 0; i < 32; ++i)
+    level[i] = (fertile >> i) & 1 ? ~uint64_t(0) : 0;
+  for (int v = 4, width = 16; v >= 0; --v, width /= 2)
+    for (int k = 0; k < width; ++k)
+      level[k] = (vars[v] & level[2 * k + 1]) | (~vars[v] & level[2 * k]);
+  return level[0];
+}
+
+struct pots {
+  // Number of the pot in bit 0 of state[0]
+  long leftmost{0};
+  // What's growing in the represented pots, 64 per word, pot leftmost
+  // + 64 * i + j in bit j of state[i].  Kept normalized so that bit 0
+  // of state[0] is always a plant and the last word isn't empty.
+  vector<uint64_t> state;
+  // Rules that produce plants.  Bit i is set if the pattern with
+  // index i produces a plant, where the index of a pattern of pots
+  // p-2 ... p+2 is p-2 as the high bit down to p+2 as the low bit.
+  uint32_t fertile{0};
+
+  // Construct from stdin
+  pots();
+
+  // Run one generation.  Return true if a repeat of the state is
+  // detected.  (The value of leftmost may change however, i.e., the
+  // state can be shifting along.)
+  bool grow();
+
+  // Shift state so that it's normalized, adjusting leftmost
+  void normalize(vector<uint64_t> &next);
+
+  // Do the growing pot number sum thing
+  long plant_pots() const;
+};
+
+pots::pots() {
+  string _, initial;
+  cin >> _ >> _ >> initial;
+  state.assign((initial.length() + 63) / 64, 0);
+  for (size_t i = 0; i < initial.length(); ++i)
+    if (initial[i] == '#')
+      state[i / 64] |= uint64_t(1) << (i % 64);
+  string pattern;
+  char next;
+  while (cin >> pattern >> _ >> next) {
+    assert(pattern.length() == 5);
+    assert(next == '#' || next == '.');
+    int index = 0;
+    for (char c : pattern)
+      index = 2 * index + (c == '#');
+    if (next == '#')
+      fertile |= uint32_t(1) << index;
+  }
+  assert(!(fertile & 1));
+  auto normalized = state;
+  normalize(normalized);
+  state = normalized;
+}
+
+void pots::normalize(vector<uint64_t> &next) {
+  size_t first = 0;
+  while (first < next.size() && next[first] == 0)
+    ++first;
+  if (first == next.size()) {
+    // Everything died
+    next.clear();
+    return;
+  }
+  int shift = __builtin_ctzll(next[first]);
+  leftmost += 64 * first + shift;
+  for (size_t i = first; i < next.size(); ++i) {
+    uint64_t word = next[i] >> shift;
+    if (shift > 0 && i + 1 < next.size())
+      word |= next[i + 1] << (64 - shift);
+    next[i - first] = word;
+  }
+  next.resize(next.size() - first);
+  while (next.back() == 0)
+    next.pop_back();
+}
+
+bool pots::grow() {
+  // Make sure there's room for plants to spread two pots either way
+  // by adding an empty word at each end
+  size_t n = state.size() + 2;
+  auto word = [&](size_t i) {
+                return 0 < i && i < n - 1 ? state[i - 1] : uint64_t(0);
+              };
+  leftmost -= 64;
+  vector<uint64_t> next(n);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t prev = i > 0 ? word(i - 1) : 0;
+    uint64_t here = word(i);
+    uint64_t after = i + 1 < n ? word(i + 1) : 0;
+    // Bit j of each of these is pot j's neighbor at that offset, from
+    // the high bit of the rule index down to the low bit
+    uint64_t vars[5] = {
+      (here << 2) | (prev >> 62),
+      (here << 1) | (prev >> 63),
+      here,
+      (here >> 1) | (after << 63),
+      (here >> 2) | (after << 62)
+    };
+    next[i] = apply_rules(fertile, vars);
+  }
+  // Trim as much as possible, adjust leftmost, and note if the state
+  // is unchanged
+  normalize(next);
+  bool repeating = state == next;
+  state = next;
+  return repeating;
+}
+
+long pots::plant_pots() const {
+  long result = 0;
+  for (size_t i = 0; i < state.size(); ++i)
+    for (uint64_t word = state[i]; word != 0; word &= word - 1)
+      result += leftmost + 64 * long(i) + __builtin_ctzll(word);
+  return result;
+}
+
+// Level of the leaves; they're 16 pots in a uint16_t
+int const leaf_level = 4;
+
+struct hashlife {
+  uint32_t fertile;
+
+  struct node {
+    int level;
+    // Children for level > leaf_level
+    uint32_t left, right;
+    // Pots for leaves, pot i in bit i
+    uint16_t bits;
+    // Number of plants, and sum of their offsets within the node
+    long population;
+    __int128 offset_sum;
+  };
+  vector<node> nodes;
+  // Hash-consing
+  vector<int64_t> leaf_ids;
+  unordered_map<uint64_t, uint32_t> joined;
+  // Memoized results; key is node id << 8 | j
+  unordered_map<uint64_t, uint32_t> results;
+  // Empty node at each level
+  vector<uint32_t> empties;
+
+  // The current state: root, and the number of the pot at its offset
+  // 0
+  uint32_t root;
+  long origin;
+
+  // Start with the pots' state
+  hashlife(pots const &p);
+
+  uint32_t leaf(uint16_t bits);
+  uint32_t join(uint32_t left, uint32_t right);
+  uint32_t empty(int level);
+  // Middle half of a node, no time passing
+  uint32_t center(uint32_t id);
+  // Middle half of a node 2^j generations later, j <= level - 3
+  uint32_t result(uint32_t id, int j);
+
+  // Width of a node at a level
+  static long width(int level) { return long(1) << level; }
+
+  // Grow the root to twice the size with the current root in the
+  // middle
+  void expand();
+  // Advance the state 2^j generations
+  void advance(int j);
+  // Advance the state by some number of generations
+  void advance_by(long generations);
+
+  long plant_pots() const;
+
+private:
+  // Build a node for pots origin + offset ... from a normalized state
+  uint32_t build(vector<uint64_t> const &state, int level, long offset);
+};
+
+hashlife::hashlife(pots const &p) :
+  fertile(p.fertile), leaf_ids(1 << 16, -1) {
+  long pots = 64 * p.state.size();
+  int level = leaf_level + 1;
+  while (width(level) < pots)
+    ++level;
+  root = build(p.state, level, 0);
+  origin = p.leftmost;
+}
+
+uint32_t hashlife::build(vector<uint64_t> const &state, int level,
+                         long offset) {
+  if (offset >= long(64 * state.size()))
+    return empty(level);
+  if (level == leaf_level)
+    return leaf(uint16_t(state[offset / 64] >> (offset % 64)));
+  long half = width(level - 1);
+  return join(build(state, level - 1, offset),
+              build(state, level - 1, offset + half));
+}
+
+uint32_t hashlife::leaf(uint16_t bits) {
+  auto &id = leaf_ids[bits];
+  if (id < 0) {
+    id = nodes.size();
+    node n{ leaf_level, 0, 0, bits, __builtin_popcount(bits), 0 };
+    for (int i = 0; i < 16; ++i)
+      if ((bits >> i) & 1)
+        n.offset_sum += i;
+    nodes.push_back(n);
+  }
+  return id;
+}
+
+uint32_t hashlife::join(uint32_t left, uint32_t right) {
+  auto [p, inserted] = joined.emplace(uint64_t(left) << 32 | right, 0);
+  if (inserted) {
+    p->second = nodes.size();
+    auto const &l = nodes[left];
+    auto const &r = nodes[right];
+    assert(l.level == r.level);
+    node n{ l.level + 1, left, right, 0, l.population + r.population,
+            l.offset_sum + r.offset_sum +
+            __int128(r.population) * width(l.level) };
+    nodes.push_back(n);
+  }
+  return p->second;
+}
+
+uint32_t hashlife::empty(int level) {
+  while (int(empties.size()) <= level) {
+    int k = empties.size();
+    if (k < leaf_level)
+      empties.push_back(0);
+    else if (k == leaf_level)
+      empties.push_back(leaf(0));
+    else
+      empties.push_back(join(empties[k - 1], empties[k - 1]));
+  }
+  return empties[level];
+}
+
+uint32_t hashlife::center(uint32_t id) {
+  auto const &n = nodes[id];
+  assert(n.level > leaf_level);
+  auto const &l = nodes[n.left];
+  auto const &r = nodes[n.right];
+  if (n.level == leaf_level + 1)
+    return leaf(uint16_t((l.bits >> 8) | (r.bits << 8)));
+  return join(l.right, r.left);
+}
+
+uint32_t hashlife::result(uint32_t id, int j) {
+  int k = nodes[id].level;
+  assert(k > leaf_level && 0 <= j && j <= k - 3);
+  uint64_t key = uint64_t(id) << 8 | j;
+  auto p = results.find(key);
+  if (p != results.end())
+    return p->second;
+  uint32_t res;
+  uint32_t left = nodes[id].left;
+  uint32_t right = nodes[id].right;
+  if (k == leaf_level + 1) {
+    // 32 pots, just run the rules.  Pots near the edges go wrong, but
+    // the middle 16 are still right after up to 4 generations.
+    uint64_t pots = nodes[left].bits | uint64_t(nodes[right].bits) << 16;
+    for (int _ = 0; _ < (1 << j); ++_) {
+      uint64_t vars[5] = { pots << 2, pots << 1, pots, pots >> 1, pots >> 2 };
+      pots = apply_rules(fertile, vars) & 0xffffffff;
+    }
+    res = leaf(uint16_t(pots >> 8));
+  } else {
+    // Three overlapping half-size nodes across the middle
+    uint32_t a = left;
+    uint32_t b = join(nodes[left].right, nodes[right].left);
+    uint32_t c = right;
+    if (j == k - 3) {
+      // Two steps of 2^(j-1) generations each
+      uint32_t ra = result(a, j - 1);
+      uint32_t rb = result(b, j - 1);
+      uint32_t rc = result(c, j - 1);
+      res = join(result(join(ra, rb), j - 1), result(join(rb, rc), j - 1));
+    } else {
+      // The half-size nodes can do all 2^j generations themselves
+      uint32_t ra = result(a, j);
+      uint32_t rb = result(b, j);
+      uint32_t rc = result(c, j);
+      res = join(center(join(ra, rb)), center(join(rb, rc)));
+    }
+  }
+  results.emplace(key, res);
+  return res;
+}
+
+void hashlife::expand() {
+  int k = nodes[root].level;
+  uint32_t left = nodes[root].left;
+  uint32_t right = nodes[root].right;
+  uint32_t e = empty(k - 1);
+  root = join(join(e, left), join(right, e));
+  origin -= width(k - 1);
+}
+
+void hashlife::advance(int j) {
+  // Plants spread at most 2 pots per generation, so 2^j generations
+  // can spread 2^(j+1).  Putting the root in the middle quarter of a
+  // node four times as big leaves a margin of half the root's width
+  // on each side of the result.
+  while (nodes[root].level < j + 2)
+    expand();
+  expand();
+  expand();
+  int k = nodes[root].level;
+  root = result(root, j);
+  origin += width(k - 2);
+  // Trim empty space
+  while (nodes[root].level > leaf_level + 1) {
+    auto const &n = nodes[root];
+    if (nodes[nodes[n.left].left].population != 0 ||
+        nodes[nodes[n.right].right].population != 0)
+      break;
+    origin += width(n.level - 2);
+    root = center(root);
+  }
+}
+
+void hashlife::advance_by(long generations) {
+  for (int j = 62; j >= 0; --j)
+    if ((generations >> j) & 1)
+      advance(j);
+}
+
+long hashlife::plant_pots() const {
+  auto const &n = nodes[root];
+  return long(n.offset_sum + __int128(origin) * n.population);
+}
+
+struct state_hash {
+  size_t operator()(vector<uint64_t> const &state) const {
+    size_t h = state.size();
+    for (auto word : state)
+      h = h * 0x9e3779b97f4a7c15 ^ (word + (h >> 17));
+    return h;
+  }
+};
+
+long solve(long generations) {
+  pots p;
+  // Generation when each shape was seen
+  unordered_map<vector<uint64_t>, long, state_hash> seen;
+  // { leftmost, plant_pots(), number of plants } for each generation
+  vector<tuple<long, long, long>> history;
+  for (long g = 0; g < generations && g < max_direct; ++g) {
+    auto [it, inserted] = seen.emplace(p.state, g);
+    if (!inserted) {
+      // Same shape as generation g1, shifted by d.  Generation g1 + i
+      // * period + offset is generation g1 + offset shifted by i * d.
+      long g1 = it->second;
+      long period = g - g1;
+      long d = p.leftmost - get<0>(history[g1]);
+      long cycles = (generations - g1) / period;
+      long offset = (generations - g1) % period;
+      auto [_, sum, population] = history[g1 + offset];
+      return sum + population * d * cycles;
+    }
+    long population = 0;
+    for (auto word : p.state)
+      population += __builtin_popcountll(word);
+    history.emplace_back(p.leftmost, p.plant_pots(), population);
+    p.grow();
+  }
+  if (long(history.size()) == generations)
+    return p.plant_pots();
+  hashlife h(p);
+  h.advance_by(generations - history.size());
+  return h.plant_pots();
+}
+
+void part1() { cout << solve(20) << '\n'; }
+void part2() { cout << solve(50000000000) << '\n'; }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}
@@ -8,6 +8,7 @@
 #include <vector>
 #include <optional>
 #include <algorithm>
+#include <iterator>
 #include <cassert>
 
 using namespace std;
@@ -82,11 +83,21 @@ void cart::turn(char track) {
     next_turn = -1;
 }
 
+// Row-major order, the order carts move in
+bool before(cart const &c1, cart const &c2) {
+  if (c1.xy.second != c2.xy.second)
+    return c1.xy.second < c2.xy.second;
+  return c1.xy.first < c2.xy.first;
+}
+
 struct racetrack {
   // The track (with all carts removed)
   vector<string> track;
-  // The carts (reordered for each tick)
+  int width;
+  // The carts that haven't crashed, kept in the order they move
   vector<cart> carts;
+  // Index in carts of the cart at each cell, or -1 if it's empty
+  vector<int> occupant;
 
   // Construct from stdin
   racetrack();
@@ -94,6 +105,11 @@ struct racetrack {
   // The stretch of track is at the given coordinates
   char at(coords const &c) const;
 
+  // Index of the given coordinates in occupant
+  size_t cell(coords const &c) const {
+    return size_t(c.second) * width + c.first;
+  }
+
   // Do one tick, return either the location of the first crash, or
   // the location of the last surviving cart (or null if there's no
   // crash and multiple carts running)
@@ -121,47 +137,67 @@ racetrack::racetrack() {
     assert(track.front().length() == row.length());
   }
   assert(!track.empty());
+  width = track.front().length();
+  sort(carts.begin(), carts.end(), before);
+  occupant.assign(track.size() * width, -1);
+  for (size_t i = 0; i < carts.size(); ++i)
+    occupant[cell(carts[i].xy)] = i;
 }
 
 char racetrack::at(coords const &c) const {
-  assert(c.first >= 0 && c.first < int(track.front().length()));
+  assert(c.first >= 0 && c.first < width);
   assert(c.second >= 0 && c.second < int(track.size()));
   return track[c.second][c.first];
 }
 
+// Collisions are found by looking at the destination cell in
+// occupant, so a tick is linear in the number of carts.
+//
+// Carts that move sideways stay in their row, and two of them can't
+// pass each other without crashing, so they're still in order at the
+// end of the tick.  Only the carts that moved up or down need sorting,
+// and they're merged back in with the rest.
 optional<coords> racetrack::tick(bool first_crash) {
-  sort(carts.begin(), carts.end(),
-       [](auto const &c1, auto const &c2) {
-         if (c1.xy.second != c2.xy.second)
-           return c1.xy.second < c2.xy.second;
-         return c1.xy.first < c2.xy.first;
-       });
-  for (auto &c : carts) {
+  // Which carts changed rows
+  vector<bool> vertical(carts.size());
+  for (size_t i = 0; i < carts.size(); ++i) {
+    auto &c = carts[i];
     if (c.crashed)
       // Already crashed into some other cart
       continue;
+    vertical[i] = c.dir.second != 0;
+    occupant[cell(c.xy)] = -1;
     c.forward();
-    for (auto &other : carts) {
-      if (!other.crashed && c.id != other.id && c.xy == other.xy) {
-        c.crashed = true;
-        other.crashed = true;
-        if (first_crash)
-          return c.xy;
-      }
+    char track_here = at(c.xy);
+    int &other = occupant[cell(c.xy)];
+    if (other != -1) {
+      c.crashed = true;
+      carts[other].crashed = true;
+      other = -1;
+      if (first_crash)
+        return c.xy;
+      continue;
     }
-    c.turn(at(c.xy));
+    other = i;
+    c.turn(track_here);
   }
-  optional<coords> result;
-  if (!first_crash)
-    // See if there's a lone survivor
-    for (auto const &c : carts)
-      if (!c.crashed) {
-        if (result)
-          // Multiple surviving carts
-          return nullopt;
-        result = c.xy;
-      }
-  return result;
+  // Drop the crashed carts and restore the order
+  vector<cart> stayed;
+  vector<cart> moved;
+  for (size_t i = 0; i < carts.size(); ++i)
+    if (!carts[i].crashed)
+      (vertical[i] ? moved : stayed).push_back(carts[i]);
+  assert(is_sorted(stayed.begin(), stayed.end(), before));
+  sort(moved.begin(), moved.end(), before);
+  carts.clear();
+  merge(stayed.begin(), stayed.end(), moved.begin(), moved.end(),
+        back_inserter(carts), before);
+  for (size_t i = 0; i < carts.size(); ++i)
+    occupant[cell(carts[i].xy)] = i;
+  if (!first_crash && carts.size() == 1)
+    // A lone survivor
+    return carts.front().xy;
+  return nullopt;
 }
 
 void race(bool first_crash) {
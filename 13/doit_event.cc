@@ -0,0 +1,432 @@
+// -*- C++ -*-
+// g++ -std=c++17 -Wall -g -O2 -o doit_event doit_event.cc
+// ./doit_event 1 < input  # part 1
+// ./doit_event 2 < input  # part 2
+
+// Alternative to doit.cc that doesn't go tick by tick.  A cart on
+// '-' or '|' can't do anything but keep going, so its position is a
+// linear function of time until it reaches the next curve or
+// intersection.  Each of those straight stretches is a leg.  The
+// distance from every cell in every direction to the next curve or
+// intersection is computed up front, so the end of a leg is known
+// when it starts.
+//
+// Within a tick carts move in row-major order, so for carts X and Y
+// with X moving first, X crashes into Y if X moves to where Y is still
+// sitting, and Y crashes into X if Y moves to where X has just gone.
+// For two legs those conditions are linear equations in the tick
+// number, so the first crash of any pair of legs can be solved for
+// directly.  Legs only share cells if they're on the same run of
+// track between curves or intersections, or on runs that meet at a
+// curve or intersection, so each new leg is only checked against the
+// legs of carts on nearby runs.
+//
+// Events are then the ends of legs and the crashes, processed in
+// order of tick and position within the tick.  A crash involving a
+// cart that's already gone is ignored.  On a long, sparse track that's
+// far fewer events than there are ticks times carts.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <queue>
+#include <tuple>
+#include <optional>
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+using coords = pair<int, int>;
+
+coords operator+(coords const &c1, coords const &c2) {
+  return { c1.first + c2.first, c1.second + c2.second };
+}
+
+coords operator-(coords const &c) { return { -c.first, -c.second }; }
+
+coords operator*(coords const &c, int k) {
+  return { c.first * k, c.second * k };
+}
+
+coords rotate(coords dir, int l_or_r) {
+  assert(abs(l_or_r) <= 1);
+  if (l_or_r == 0)
+    return dir;
+  if (l_or_r == -1)
+    l_or_r = 3;
+  while (l_or_r-- > 0)
+    dir = { -dir.second, dir.first };
+  return dir;
+}
+
+// Row-major order, the order carts move in
+bool before(coords const &c1, coords const &c2) {
+  if (c1.second != c2.second)
+    return c1.second < c2.second;
+  return c1.first < c2.first;
+}
+
+// The four directions, indexed for racetrack::straight
+coords const directions[4] = { { +1, 0 }, { 0, +1 }, { -1, 0 }, { 0, -1 } };
+
+int direction_index(coords const &dir) {
+  return find(directions, directions + 4, dir) - directions;
+}
+
+struct cart {
+  // For distinguishing carts
+  unsigned id;
+  // Where the cart is at the start of its leg
+  coords xy;
+  // The direction it's moving
+  coords dir;
+  // Turn it makes at the next intersection, left = -1, straight = 0,
+  // right = +1
+  int next_turn{-1};
+  // Has the cart crashed into some other?
+  bool crashed{false};
+  // The leg starts after tick t0 (the cart's at xy then) and ends at
+  // a curve or intersection after tick t1
+  long t0{0};
+  long t1{0};
+  // The run of track the leg is on, and the cart's index in the list
+  // of carts on that run
+  int run{-1};
+  int run_index{-1};
+
+  cart(unsigned id_, coords const &xy_, coords const &dir_) :
+    id(id_), xy(xy_), dir(dir_) {}
+
+  // Where the cart is after tick t, t0 <= t <= t1
+  coords at(long t) const { return xy + dir * int(t - t0); }
+
+  void turn(char track);
+};
+
+void cart::turn(char track) {
+  if (crashed)
+    return;
+  // Driving straight
+  if (track == '-') {
+    assert(abs(dir.second) == 0);
+    return;
+  }
+  if (track == '|') {
+    assert(abs(dir.first) == 0);
+    return;
+  }
+  // Going around a curve
+  if (track == '/') {
+    swap(dir.first, dir.second);
+    dir = -dir;
+    return;
+  }
+  if (track == '\\') {
+    swap(dir.first, dir.second);
+    return;
+  }
+  // At an intersection
+  assert(track == '+');
+  dir = rotate(dir, next_turn);
+  if (++next_turn == +2)
+    next_turn = -1;
+}
+
+// A crash of two carts
+struct crash {
+  // Tick it happens in
+  long t;
+  // Where the cart that moves into the other starts the tick, which
+  // fixes when in the tick the crash happens
+  coords slot;
+  // Where the crash is
+  coords where;
+};
+
+// Tick t when a is at b's position eb ticks earlier than t, with a
+// itself ea ticks earlier, if there's exactly one such tick
+optional<long> meet(cart const &a, int ea, cart const &b, int eb) {
+  optional<long> t;
+  auto solve = [&](int as, int ad, int bs, int bd) {
+                 // (ad - bd) t = bs - bd (b.t0 + eb) - as + ad (a.t0 + ea)
+                 long k = ad - bd;
+                 long c = bs - bd * (b.t0 + eb) - as + ad * (a.t0 + ea);
+                 if (k == 0)
+                   return c == 0;
+                 if (c % k != 0 || (t && *t != c / k))
+                   return false;
+                 t = c / k;
+                 return true;
+               };
+  if (!solve(a.xy.first, a.dir.first, b.xy.first, b.dir.first) ||
+      !solve(a.xy.second, a.dir.second, b.xy.second, b.dir.second))
+    return nullopt;
+  return t;
+}
+
+// The first crash of a and b during their current legs, if any
+optional<crash> first_crash(cart const &a, cart const &b) {
+  long lo = max(a.t0, b.t0) + 1;
+  long hi = min(a.t1, b.t1);
+  if (lo > hi)
+    return nullopt;
+  if (a.dir == b.dir) {
+    // One following right behind the other crashes at once if it
+    // moves first, otherwise never
+    coords pa = a.at(lo - 1);
+    coords pb = b.at(lo - 1);
+    if (pa + a.dir == pb && before(pa, pb))
+      return crash{ lo, pa, pb };
+    if (pb + b.dir == pa && before(pb, pa))
+      return crash{ lo, pb, pa };
+    return nullopt;
+  }
+  optional<crash> result;
+  auto consider = [&](crash const &c) {
+                    if (!result || make_tuple(c.t, c.slot.second, c.slot.first) <
+                        make_tuple(result->t, result->slot.second,
+                                   result->slot.first))
+                      result = c;
+                  };
+  auto in_range = [&](optional<long> t) { return t && lo <= *t && *t <= hi; };
+  // Both end up in the same cell, the second to move crashes
+  if (auto t = meet(a, 0, b, 0); in_range(t)) {
+    coords pa = a.at(*t - 1);
+    coords pb = b.at(*t - 1);
+    consider({ *t, before(pa, pb) ? pb : pa, a.at(*t) });
+  }
+  // One moves first into the other's cell
+  if (auto t = meet(a, 0, b, 1); in_range(t) && before(a.at(*t - 1), b.at(*t - 1)))
+    consider({ *t, a.at(*t - 1), a.at(*t) });
+  if (auto t = meet(b, 0, a, 1); in_range(t) && before(b.at(*t - 1), a.at(*t - 1)))
+    consider({ *t, b.at(*t - 1), b.at(*t) });
+  return result;
+}
+
+// Something happening to a cart
+struct event {
+  long t;
+  coords slot;
+  // Crashes of carts a and b happen before a leg ending for cart a at
+  // the same time
+  enum { crash, leg_end } kind;
+  int a, b;
+  // Location of the crash
+  coords where;
+
+  auto key() const { return make_tuple(t, slot.second, slot.first, kind); }
+  bool operator>(event const &other) const { return key() > other.key(); }
+};
+
+struct racetrack {
+  // The track (with all carts removed)
+  vector<string> track;
+  int width;
+  vector<cart> carts;
+  // Number of steps from each cell in each of the directions to the
+  // next curve or intersection, or 0 if the track ends first
+  vector<array<int, 4>> straight;
+  // The carts on each run of track, see run_of
+  vector<vector<int>> on_run;
+  // Events not yet processed, first on top
+  priority_queue<event, vector<event>, greater<event>> events;
+  // Number of carts that haven't crashed
+  size_t running;
+
+  // Construct from stdin
+  racetrack();
+
+  // The stretch of track is at the given coordinates
+  char at(coords const &c) const;
+
+  // Index of the given coordinates
+  size_t cell(coords const &c) const {
+    return size_t(c.second) * width + c.first;
+  }
+
+  // A curve or an intersection
+  bool turns(coords const &c) const { return at(c) != '-' && at(c) != '|'; }
+
+  // Steps from c in direction dir to the next curve or intersection
+  int steps(coords const &c, coords const &dir) const {
+    return straight[cell(c)][direction_index(dir)];
+  }
+
+  // The run of track leaving the curve or intersection at c in
+  // direction dir.  Runs are numbered by their upper left end and
+  // whether they're horizontal or vertical.
+  int run_of(coords const &c, coords const &dir) const;
+
+  // Start cart i on its next leg at tick t, adding the events for it
+  void start_leg(int i, long t);
+
+  // Take cart i off the run it's on
+  void leave_run(int i);
+
+  // Run until the first crash, or until there's one cart left, and
+  // return where that happens
+  coords race(bool first_crash);
+};
+
+racetrack::racetrack() {
+  auto place_carts =
+    [&](char c, string &s, coords const &dir) {
+      while (auto pos = s.find(c)) {
+        if (pos == string::npos)
+          return;
+        coords xy{ pos, track.size() };
+        carts.emplace_back(carts.size(), xy, dir);
+        s[pos] = dir.second == 0 ? '-' : '|';
+      }
+    };
+  string row;
+  while (getline(cin, row)) {
+    place_carts('<', row, { -1, 0 });
+    place_carts('>', row, { +1, 0 });
+    place_carts('^', row, { 0, -1 });
+    place_carts('v', row, { 0, +1 });
+    track.push_back(row);
+    assert(track.front().length() == row.length());
+  }
+  assert(!track.empty());
+  width = track.front().length();
+  int height = track.size();
+  // Fill in straight for each direction, working backwards from the
+  // far edge so that the next cell is always done first
+  straight.resize(size_t(height) * width);
+  for (int d = 0; d < 4; ++d) {
+    coords dir = directions[d];
+    for (int iy = 0; iy < height; ++iy)
+      for (int ix = 0; ix < width; ++ix) {
+        coords c{ dir.first > 0 ? width - 1 - ix : ix,
+                  dir.second > 0 ? height - 1 - iy : iy };
+        coords next = c + dir;
+        int &s = straight[cell(c)][d];
+        if (next.first < 0 || next.first >= width ||
+            next.second < 0 || next.second >= height || at(next) == ' ')
+          s = 0;
+        else if (turns(next))
+          s = 1;
+        else {
+          int further = straight[cell(next)][d];
+          s = further == 0 ? 0 : further + 1;
+        }
+      }
+  }
+  on_run.resize(2 * straight.size());
+}
+
+char racetrack::at(coords const &c) const {
+  assert(c.first >= 0 && c.first < width);
+  assert(c.second >= 0 && c.second < int(track.size()));
+  return track[c.second][c.first];
+}
+
+int racetrack::run_of(coords const &c, coords const &dir) const {
+  int s = steps(c, dir);
+  assert(s > 0);
+  size_t end1 = cell(c);
+  size_t end2 = cell(c + dir * s);
+  return 2 * min(end1, end2) + (dir.first == 0 ? 1 : 0);
+}
+
+void racetrack::start_leg(int i, long t) {
+  auto &c = carts[i];
+  int s = steps(c.xy, c.dir);
+  // Running off the end of the track
+  assert(s > 0);
+  c.t0 = t;
+  c.t1 = t + s;
+  coords end = c.at(c.t1);
+  events.push({ c.t1, c.at(c.t1 - 1), event::leg_end, i, i, end });
+  // The run the leg is on, and the runs meeting it at either end
+  c.run = run_of(end, -c.dir);
+  vector<int> nearby{ c.run };
+  coords other_end = end + (-c.dir) * steps(end, -c.dir);
+  for (coords e : { end, other_end })
+    for (coords dir : directions)
+      if (steps(e, dir) > 0)
+        nearby.push_back(run_of(e, dir));
+  sort(nearby.begin(), nearby.end());
+  nearby.erase(unique(nearby.begin(), nearby.end()), nearby.end());
+  for (int run : nearby)
+    for (int j : on_run[run])
+      if (auto crash = first_crash(c, carts[j]))
+        events.push({ crash->t, crash->slot, event::crash, i, j, crash->where });
+  c.run_index = on_run[c.run].size();
+  on_run[c.run].push_back(i);
+}
+
+void racetrack::leave_run(int i) {
+  auto &c = carts[i];
+  auto &others = on_run[c.run];
+  int last = others.back();
+  others[c.run_index] = last;
+  carts[last].run_index = c.run_index;
+  others.pop_back();
+}
+
+coords racetrack::race(bool first_crash) {
+  running = carts.size();
+  assert(running > 0);
+  for (size_t i = 0; i < carts.size(); ++i)
+    start_leg(i, 0);
+  if (!first_crash && running == 1)
+    // The loner still gets a tick
+    return carts.front().at(1);
+  while (true) {
+    assert(!events.empty());
+    event e = events.top();
+    events.pop();
+    auto &a = carts[e.a];
+    auto &b = carts[e.b];
+    if (a.crashed || b.crashed)
+      // Someone got there first
+      continue;
+    if (e.kind == event::leg_end) {
+      // Turn and head off on the next leg
+      leave_run(e.a);
+      a.xy = a.at(e.t);
+      a.turn(at(a.xy));
+      start_leg(e.a, e.t);
+      continue;
+    }
+    if (first_crash)
+      return e.where;
+    a.crashed = true;
+    b.crashed = true;
+    leave_run(e.a);
+    leave_run(e.b);
+    running -= 2;
+    assert(running > 0);
+    if (running == 1)
+      // The survivor finishes the tick.  Either it's already started a
+      // new leg at this tick, or its current leg lasts until then.
+      for (auto const &c : carts)
+        if (!c.crashed)
+          return c.at(e.t);
+  }
+}
+
+void race(bool first_crash) {
+  racetrack track;
+  coords ans = track.race(first_crash);
+  cout << ans.first << ',' << ans.second << '\n';
+}
+
+void part1() { race(true); }
+void part2() { race(false); }
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "usage: " << argv[0] << " partnum < input\n";
+    exit(1);
+  }
+  if (*argv[1] == '1')
+    part1();
+  else
+    part2();
+  return 0;
+}